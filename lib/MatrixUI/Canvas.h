@@ -0,0 +1,405 @@
+#ifndef Canvas_H
+#define Canvas_H
+#include <FastLED_NeoMatrix.h>
+#include <algorithm>
+#include <vector>
+
+#define CANVAS_UNMAPPED 0xFFFF
+
+// Row major pixels of something drawn on its own, e.g. an app, with one coverage bit per
+// pixel. Only covered pixels are drawn when the layer is blitted, so a pixel drawn black
+// hides what is below it while a pixel that wasn't drawn at all lets it show through.
+struct CanvasLayer
+{
+  std::vector<CRGB> pixels;
+  std::vector<uint8_t> mask;
+
+  static size_t bytesFor(size_t count)
+  {
+    return count * sizeof(CRGB) + (count + 7) / 8;
+  }
+
+  inline bool covers(uint16_t i) const
+  {
+    return mask[i >> 3] & (1 << (i & 7));
+  }
+
+  size_t bytes() const
+  {
+    return pixels.capacity() * sizeof(CRGB) + mask.capacity();
+  }
+
+  void release()
+  {
+    pixels.clear();
+    pixels.shrink_to_fit();
+    mask.clear();
+    mask.shrink_to_fit();
+  }
+};
+
+// Direct access to the LED framebuffer for code that fills many pixels per frame.
+// Bypasses the virtual Adafruit_GFX drawPixel path; every primitive clips its
+// area once and then writes straight into leds[]. The layout and rotation are
+// resolved into lookup tables whenever the canvas is bound to a matrix.
+// While a layer is recorded, every pixel written through the canvas or through
+// drawPixel of the matrix is marked as covered in the mask of the layer.
+class Canvas
+{
+private:
+  FastLED_NeoMatrix *mtx = nullptr;
+  CRGB *fb = nullptr;
+  int16_t w = 0;
+  int16_t h = 0;
+  int16_t rawWidth = 0;
+  std::vector<uint16_t> layout;  // unrotated pixel -> LED index, what drawPixel resolves to
+  std::vector<uint16_t> map;     // row major logical pixel -> LED index
+  std::vector<uint16_t> inverse; // LED index -> row major logical pixel
+  uint8_t *coverage = nullptr;   // mask of the layer being recorded
+  uint8_t red5[32];
+  uint8_t green6[64];
+  uint8_t blue5[32];
+
+  Canvas() = default;
+
+  // Clips a rectangle to the visible area, returns false if nothing is left
+  bool clip(int16_t &x, int16_t &y, int16_t &w, int16_t &h, int16_t &skipX, int16_t &skipY) const
+  {
+    skipX = x < 0 ? -x : 0;
+    skipY = y < 0 ? -y : 0;
+    x += skipX;
+    y += skipY;
+    w = std::min<int16_t>(w - skipX, width() - x);
+    h = std::min<int16_t>(h - skipY, height() - y);
+    return w > 0 && h > 0;
+  }
+
+  inline void cover(uint16_t i)
+  {
+    if (coverage)
+      coverage[i >> 3] |= 1 << (i & 7);
+  }
+
+  // Remap function of the matrix once the layout is probed, so drawPixel resolves
+  // LEDs from the same table as the canvas and marks what it draws
+  static uint16_t remapXY(uint16_t x, uint16_t y)
+  {
+    Canvas &canvas = getInstance();
+    uint16_t led = canvas.layout[y * canvas.rawWidth + x];
+    if (canvas.inverse[led] != CANVAS_UNMAPPED)
+      canvas.cover(canvas.inverse[led]);
+    return led;
+  }
+
+public:
+  static Canvas &getInstance()
+  {
+    static Canvas instance;
+    return instance;
+  }
+
+  // LED index of every unrotated pixel, taken from drawPixel itself so any
+  // layout the matrix supports ends up in the table unchanged
+  void probeLayout(std::vector<uint16_t> &layout, uint16_t count)
+  {
+    std::vector<CRGB> saved(fb, fb + count);
+    for (uint16_t led = 0; led < count; led++)
+      fb[led] = CRGB::Black;
+    for (uint16_t i = 0; i < count; i++)
+      mtx->drawPixel(i % mtx->width(), i / mtx->width(), CRGB(i >> 8, i & 0xFF, 1));
+    for (uint16_t led = 0; led < count; led++)
+      if (fb[led].b)
+        layout[(fb[led].r << 8) | fb[led].g] = led;
+    std::copy(saved.begin(), saved.end(), fb);
+  }
+
+  // Same transform Adafruit_GFX applies in drawPixel
+  void unrotate(int16_t &x, int16_t &y, uint8_t rotation, int16_t rawWidth, int16_t rawHeight) const
+  {
+    switch (rotation)
+    {
+    case 1:
+      std::swap(x, y);
+      x = rawWidth - 1 - x;
+      break;
+    case 2:
+      x = rawWidth - 1 - x;
+      y = rawHeight - 1 - y;
+      break;
+    case 3:
+      std::swap(x, y);
+      y = rawHeight - 1 - y;
+      break;
+    }
+  }
+
+  // Binds the canvas to a matrix and rebuilds the lookup tables for its current
+  // layout, remap function and rotation. RGB565 colors are expanded through the
+  // same tables the matrix uses, so blits look exactly like drawPixel. The probed
+  // layout then replaces the remap function of the matrix.
+  void begin(FastLED_NeoMatrix *matrix, CRGB *leds)
+  {
+    mtx = matrix;
+    fb = leds;
+    coverage = nullptr;
+    uint8_t rotation = mtx->getRotation();
+    mtx->setRotation(0);
+    rawWidth = mtx->width();
+    int16_t rawHeight = mtx->height();
+    uint16_t count = rawWidth * rawHeight;
+    std::vector<uint16_t> probed(count, CANVAS_UNMAPPED);
+    probeLayout(probed, count);
+    mtx->setRotation(rotation);
+
+    w = mtx->width();
+    h = mtx->height();
+    map.assign(count, 0);
+    inverse.assign(count, CANVAS_UNMAPPED);
+    for (int16_t y = 0; y < h; y++)
+    {
+      for (int16_t x = 0; x < w; x++)
+      {
+        int16_t rawX = x, rawY = y;
+        unrotate(rawX, rawY, rotation, rawWidth, rawHeight);
+        uint16_t led = probed[rawY * rawWidth + rawX];
+        // Every layout covers every pixel, the fallback only keeps writes in bounds
+        map[y * w + x] = led == CANVAS_UNMAPPED ? 0 : led;
+        if (led != CANVAS_UNMAPPED)
+          inverse[led] = y * w + x;
+      }
+    }
+
+    CRGB &probe = at(0, 0);
+    CRGB saved = probe;
+    for (uint8_t i = 0; i < 64; i++)
+    {
+      if (i < 32)
+      {
+        mtx->drawPixel(0, 0, (uint16_t)(i << 11));
+        red5[i] = probe.r;
+        mtx->drawPixel(0, 0, (uint16_t)i);
+        blue5[i] = probe.b;
+      }
+      mtx->drawPixel(0, 0, (uint16_t)(i << 5));
+      green6[i] = probe.g;
+    }
+    probe = saved;
+
+    for (uint16_t &led : probed)
+      if (led == CANVAS_UNMAPPED)
+        led = 0;
+    layout = std::move(probed);
+    mtx->setRemapFunction(remapXY);
+  }
+
+  inline int16_t width() const
+  {
+    return w;
+  }
+
+  inline int16_t height() const
+  {
+    return h;
+  }
+
+  inline bool contains(int16_t x, int16_t y) const
+  {
+    return x >= 0 && y >= 0 && x < width() && y < height();
+  }
+
+  // Unchecked access, the caller guarantees the coordinates are visible. The pixel
+  // counts as drawn by the layer being recorded.
+  inline CRGB &at(int16_t x, int16_t y)
+  {
+    uint16_t i = y * w + x;
+    cover(i);
+    return fb[map[i]];
+  }
+
+  // LED index of a visible pixel
+  inline uint16_t ledIndex(int16_t x, int16_t y) const
+  {
+    return map[y * w + x];
+  }
+
+  // Row major logical pixel shown by an LED, CANVAS_UNMAPPED if no pixel drives it
+  inline uint16_t pixelIndex(uint16_t led) const
+  {
+    return inverse[led];
+  }
+
+  inline CRGB expand(uint16_t color) const
+  {
+    return CRGB(red5[color >> 11], green6[(color >> 5) & 0x3F], blue5[color & 0x1F]);
+  }
+
+  inline void setPixel(int16_t x, int16_t y, const CRGB &color)
+  {
+    if (contains(x, y))
+      at(x, y) = color;
+  }
+
+  inline void setPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    if (contains(x, y))
+      at(x, y) = expand(color);
+  }
+
+  // Without this, named colors would silently convert to RGB565 instead of CRGB
+  inline void setPixel(int16_t x, int16_t y, CRGB::HTMLColorCode color)
+  {
+    setPixel(x, y, CRGB(color));
+  }
+
+  inline CRGB getPixel(int16_t x, int16_t y)
+  {
+    return contains(x, y) ? fb[map[y * w + x]] : CRGB(CRGB::Black);
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, const CRGB &color)
+  {
+    int16_t skipX, skipY;
+    if (!clip(x, y, w, h, skipX, skipY))
+      return;
+    for (int16_t row = y; row < y + h; row++)
+      for (int16_t col = x; col < x + w; col++)
+        at(col, row) = color;
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    fillRect(x, y, w, h, expand(color));
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, CRGB::HTMLColorCode color)
+  {
+    fillRect(x, y, w, h, CRGB(color));
+  }
+
+  // Horizontal run of len pixels starting at x
+  inline void fillSpan(int16_t x, int16_t y, int16_t len, const CRGB &color)
+  {
+    fillRect(x, y, len, 1, color);
+  }
+
+  // Vertical run of len pixels starting at y
+  inline void fillColumn(int16_t x, int16_t y, int16_t len, const CRGB &color)
+  {
+    fillRect(x, y, 1, len, color);
+  }
+
+  void clear()
+  {
+    fillRect(0, 0, width(), height(), CRGB(CRGB::Black));
+  }
+
+  // Copies a row major RGB565 bitmap
+  void blit(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h)
+  {
+    int16_t stride = w, skipX, skipY;
+    if (!clip(x, y, w, h, skipX, skipY))
+      return;
+    bitmap += skipY * stride + skipX;
+    for (int16_t row = 0; row < h; row++, bitmap += stride)
+      for (int16_t col = 0; col < w; col++)
+        at(x + col, y + row) = expand(bitmap[col]);
+  }
+
+  // Copies a row major CRGB bitmap
+  void blit(int16_t x, int16_t y, const CRGB *bitmap, int16_t w, int16_t h)
+  {
+    int16_t stride = w, skipX, skipY;
+    if (!clip(x, y, w, h, skipX, skipY))
+      return;
+    bitmap += skipY * stride + skipX;
+    for (int16_t row = 0; row < h; row++, bitmap += stride)
+      for (int16_t col = 0; col < w; col++)
+        at(x + col, y + row) = bitmap[col];
+  }
+
+  // Copies the covered pixels of a layer recorded at the size of the canvas
+  void blit(int16_t x, int16_t y, const CanvasLayer &layer)
+  {
+    int16_t w = width(), h = height(), skipX, skipY;
+    if (layer.pixels.size() != (size_t)(w * h) || !clip(x, y, w, h, skipX, skipY))
+      return;
+    for (int16_t row = 0; row < h; row++)
+    {
+      uint16_t i = (skipY + row) * width() + skipX;
+      for (int16_t col = 0; col < w; col++, i++)
+        if (layer.covers(i))
+          at(x + col, y + row) = layer.pixels[i];
+    }
+  }
+
+  // Moves the whole visible area into a row major buffer of width() * height()
+  // pixels and leaves the framebuffer black. Neither this nor restore() count as drawing.
+  void capture(CRGB *pixels)
+  {
+    for (uint16_t i = 0; i < map.size(); i++)
+    {
+      CRGB &pixel = fb[map[i]];
+      pixels[i] = pixel;
+      pixel = CRGB::Black;
+    }
+  }
+
+  // Puts back what capture() took
+  void restore(const CRGB *pixels)
+  {
+    for (uint16_t i = 0; i < map.size(); i++)
+      fb[map[i]] = pixels[i];
+  }
+
+  // Starts recording what is drawn into the black framebuffer as the layer and returns
+  // the mask recorded so far, which endLayer() continues with
+  uint8_t *beginLayer(CanvasLayer &layer)
+  {
+    layer.mask.assign((map.size() + 7) / 8, 0);
+    uint8_t *outer = coverage;
+    coverage = layer.mask.data();
+    return outer;
+  }
+
+  // Moves the drawn pixels into the layer and leaves the framebuffer black
+  void endLayer(CanvasLayer &layer, uint8_t *outer)
+  {
+    coverage = outer;
+    layer.pixels.resize(map.size());
+    capture(layer.pixels.data());
+  }
+
+  // Copies a row major palette indexed bitmap, index 0 leaves the pixel untouched
+  void blitIndexed(int16_t x, int16_t y, const uint8_t *indices, int16_t w, int16_t h, const CRGB *palette)
+  {
+    int16_t stride = w, skipX, skipY;
+    if (!clip(x, y, w, h, skipX, skipY))
+      return;
+    indices += skipY * stride + skipX;
+    for (int16_t row = 0; row < h; row++, indices += stride)
+      for (int16_t col = 0; col < w; col++)
+        if (indices[col])
+          at(x + col, y + row) = palette[indices[col]];
+  }
+};
+
+// Adafruit_GFX primitives drawn while this is alive use a 24 bit color, the
+// RGB565 color handed to the primitive itself is ignored
+class TrueColor
+{
+private:
+  FastLED_NeoMatrix *mtx;
+
+public:
+  TrueColor(FastLED_NeoMatrix *matrix, const CRGB &color) : mtx(matrix)
+  {
+    mtx->setPassThruColor(((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | color.b);
+  }
+
+  ~TrueColor()
+  {
+    mtx->setPassThruColor();
+  }
+};
+
+#endif
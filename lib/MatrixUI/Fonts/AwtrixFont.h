@@ -258,7 +258,7 @@ const uint8_t AwtrixBitmaps[] PROGMEM = {
 };
 
 /* {offset, width, height, advance cursor, x offset, y offset} */
-const GFXglyph AwtrixFontGlyphs[] PROGMEM = {
+constexpr GFXglyph AwtrixFontGlyphs[] PROGMEM = {
     {0, 8, 1, 2, 0, -5},   /*[0]    0x20 space */
     {1, 8, 5, 2, 0, -5},   /*[1]    0x21 exclam */
     {6, 8, 2, 4, 0, -5},   /*[2]    0x22 quotedbl */
@@ -1,6 +1,148 @@
 #ifndef GifPlayer_H
 #define GifPlayer_H
 #include <LittleFS.h>
+#include "Canvas.h"
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <vector>
+
+#define GIF_CACHE_MAX_FRAMES 128
+
+// A GIF decoded once into palette indexed frames. Pixel index 0 means the
+// frame does not touch that pixel, every other index points into the palette.
+struct GifAsset
+{
+  String name;
+  uint8_t width;
+  uint8_t height;
+  std::vector<CRGB> palette;
+  std::vector<uint8_t> pixels;
+  std::vector<uint32_t> delays; // in ms
+
+  size_t bytes() const
+  {
+    return palette.size() * sizeof(CRGB) + pixels.size() + delays.size() * sizeof(uint32_t);
+  }
+};
+
+// Decoded GIFs shared by all GifPlayer instances, evicted in LRU order once the byte budget is exceeded.
+// GIFs that can't be cached are remembered, so they are streamed without another decode attempt.
+class GifCache
+{
+private:
+  std::list<std::shared_ptr<GifAsset>> assets; // most recently used first
+  std::vector<String> rejected;
+  size_t usedBytes = 0;
+  size_t budget = 0;
+  uint32_t generation = 0; // bumped whenever a file changed, players holding an asset check it
+
+  void evict(size_t required)
+  {
+    while (!assets.empty() && usedBytes + required > budget)
+    {
+      usedBytes -= assets.back()->bytes();
+      assets.pop_back();
+      ++evictions;
+    }
+  }
+
+public:
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t evictions = 0;
+
+  static GifCache &getInstance()
+  {
+    static GifCache instance;
+    return instance;
+  }
+
+  void setBudget(size_t bytes)
+  {
+    budget = bytes;
+    rejected.clear();
+    evict(0);
+  }
+
+  size_t getBudget()
+  {
+    return budget;
+  }
+
+  bool isEnabled()
+  {
+    return budget > 0;
+  }
+
+  std::shared_ptr<GifAsset> find(const String &name)
+  {
+    for (auto it = assets.begin(); it != assets.end(); ++it)
+    {
+      if ((*it)->name == name)
+      {
+        assets.splice(assets.begin(), assets, it);
+        ++hits;
+        return assets.front();
+      }
+    }
+    ++misses;
+    return nullptr;
+  }
+
+  bool insert(std::shared_ptr<GifAsset> asset)
+  {
+    size_t size = asset->bytes();
+    if (size > budget)
+      return false;
+    evict(size);
+    assets.push_front(asset);
+    usedBytes += size;
+    return true;
+  }
+
+  bool isRejected(const String &name)
+  {
+    return std::find(rejected.begin(), rejected.end(), name) != rejected.end();
+  }
+
+  void reject(const String &name)
+  {
+    if (!isRejected(name))
+      rejected.push_back(name);
+  }
+
+  void invalidate(const String &name)
+  {
+    ++generation;
+    rejected.erase(std::remove(rejected.begin(), rejected.end(), name), rejected.end());
+    for (auto it = assets.begin(); it != assets.end(); ++it)
+    {
+      if ((*it)->name == name)
+      {
+        usedBytes -= (*it)->bytes();
+        assets.erase(it);
+        return;
+      }
+    }
+  }
+
+  uint32_t getGeneration()
+  {
+    return generation;
+  }
+
+  size_t getUsedBytes()
+  {
+    return usedBytes;
+  }
+
+  size_t getCount()
+  {
+    return assets.size();
+  }
+};
+
 class GifPlayer
 {
 public:
@@ -53,6 +195,17 @@ private:
   int tbiPackedBits;
   boolean tbiInterlaced;
 
+  // Cached playback
+  std::shared_ptr<GifAsset> cachedGif;
+  uint32_t cacheGeneration = 0;
+  size_t cachedFrame = 0;
+  unsigned long cachedFrameTime = 0;
+
+  // Set while decoding into the cache instead of the matrix
+  GifAsset *captureAsset = nullptr;
+  uint8_t *captureFrame = nullptr;
+  bool captureFailed = false;
+
 public:
   int frameDelay;
   int transparentColorIndex;
@@ -445,10 +598,135 @@ int readIntoBuffer(void *buffer, int numberOfBytes)
     return len - l;
   }
 
+  void plotPixel(int x, int y, const CRGB &color)
+  {
+    if (!captureAsset)
+    {
+      Canvas::getInstance().setPixel(x + offsetX, y + offsetY, color);
+      return;
+    }
+    if (x < 0 || y < 0 || x >= captureAsset->width || y >= captureAsset->height)
+      return;
+    std::vector<CRGB> &palette = captureAsset->palette;
+    size_t index = 1;
+    while (index < palette.size() && palette[index] != color)
+      index++;
+    if (index == palette.size())
+    {
+      if (palette.size() > 255)
+      {
+        captureFailed = true;
+        return;
+      }
+      palette.push_back(color);
+    }
+    captureFrame[y * captureAsset->width + x] = index;
+  }
+
+  void resetDecoder()
+  {
+    memset(lastFrame, 0, sizeof(lastFrame));
+    memset(gifPalette, 0, sizeof(gifPalette));
+    memset(lzwImageData, 0, sizeof(lzwImageData));
+    memset(imageData, 0, sizeof(imageData));
+    memset(imageDataBU, 0, sizeof(imageDataBU));
+    memset(stack, 0, sizeof(stack));
+    memset(suffix, 0, sizeof(suffix));
+    memset(prefix, 0, sizeof(prefix));
+  }
+
+  // Runs the decoder over the whole file once and stores every composed frame.
+  // Gives up as soon as the frames decoded so far exceed maxBytes.
+  std::shared_ptr<GifAsset> decodeToCache(size_t maxBytes)
+  {
+    std::shared_ptr<GifAsset> asset(new GifAsset());
+    asset->name = file.name();
+    resetDecoder();
+    file.seek(0);
+    if (!parseGifHeader())
+    {
+      file.seek(0);
+      return nullptr;
+    }
+    parseLogicalScreenDescriptor();
+    parseGlobalColorTable();
+    asset->width = lsdWidth < WIDTH ? lsdWidth : WIDTH;
+    asset->height = lsdHeight < HEIGHT ? lsdHeight : HEIGHT;
+    asset->palette.push_back(CRGB::Black); // index 0 is reserved for untouched pixels
+    size_t frameSize = asset->width * asset->height;
+
+    captureAsset = asset.get();
+    captureFailed = false;
+    bool done = false;
+    while (!done && !captureFailed)
+    {
+      int b = readByte();
+      if (b == 0x2c)
+      {
+        if (asset->delays.size() >= GIF_CACHE_MAX_FRAMES || asset->bytes() + frameSize + sizeof(uint32_t) > maxBytes)
+        {
+          captureFailed = true;
+          break;
+        }
+        asset->pixels.resize(asset->pixels.size() + frameSize, 0);
+        captureFrame = &asset->pixels[asset->pixels.size() - frameSize];
+        asset->delays.push_back(parseTableBasedImage());
+      }
+      else if (b == 0x21)
+      {
+        switch (readByte())
+        {
+        case 0x01:
+          parsePlainTextExtension();
+          break;
+        case 0xf9:
+          parseGraphicControlExtension();
+          break;
+        case 0xfe:
+          parseCommentExtension();
+          break;
+        case 0xff:
+          parseApplicationExtension();
+          break;
+        default:
+          captureFailed = true;
+          break;
+        }
+      }
+      else
+      {
+        done = true;
+      }
+    }
+    captureAsset = nullptr;
+    captureFrame = nullptr;
+    file.seek(0);
+
+    if (captureFailed || asset->delays.empty())
+      return nullptr;
+    asset->pixels.shrink_to_fit();
+    asset->palette.shrink_to_fit();
+    asset->delays.shrink_to_fit();
+    return asset;
+  }
+
+  void drawCachedFrame()
+  {
+    GifAsset *asset = cachedGif.get();
+    if (millis() - cachedFrameTime >= asset->delays[cachedFrame])
+    {
+      cachedFrame = (cachedFrame + 1) % asset->delays.size();
+      cachedFrameTime = millis();
+    }
+    const uint8_t *pixels = &asset->pixels[cachedFrame * asset->width * asset->height];
+    Canvas::getInstance().blitIndexed(offsetX, offsetY, pixels, asset->width, asset->height, asset->palette.data());
+  }
+
   void redrawLastFrame()
   {
     if (needNewFrame)
       return;
+    Canvas &canvas = Canvas::getInstance();
     CRGB color;
     int yOffset, pixel;
     for (int y = tbiImageY; y < tbiHeight + tbiImageY; y++)
@@ -459,13 +737,13 @@ int readIntoBuffer(void *buffer, int numberOfBytes)
         pixel = lastFrame[yOffset + x];
         if (pixel == -99)
         {
-          mtx->drawPixel(x + offsetX, y + offsetY, mtx->Color(0, 0, 0));
+          canvas.setPixel(x + offsetX, y + offsetY, CRGB(CRGB::Black));
           continue;
         }
         color.red = gifPalette[pixel].Red;
         color.green = gifPalette[pixel].Green;
         color.blue = gifPalette[pixel].Blue;
-        mtx->drawPixel(x + offsetX, y + offsetY, color);
+        canvas.setPixel(x + offsetX, y + offsetY, color);
       }
     }
   }
@@ -518,15 +796,15 @@ int readIntoBuffer(void *buffer, int numberOfBytes)
         pixel = imageData[yOffset + x];
         if (pixel == transparentColorIndex) // Check if the pixel index is the transparent index
         {
-          mtx->drawPixel(x + offsetX, y + offsetY, mtx->Color(0, 0, 0)); // Draw a black pixel
-          lastFrame[yOffset + x] = -99;                                  // Save it as a special value
+          plotPixel(x, y, CRGB::Black); // Draw a black pixel
+          lastFrame[yOffset + x] = -99; // Save it as a special value
         }
         else
         {
           color.red = gifPalette[pixel].Red;
           color.green = gifPalette[pixel].Green;
           color.blue = gifPalette[pixel].Blue;
-          mtx->drawPixel(x + offsetX, y + offsetY, color);
+          plotPixel(x, y, color);
           lastFrame[yOffset + x] = pixel;
         }
       }
@@ -546,23 +824,45 @@ public:
     offsetX = x;
     offsetY = y;
     
-    if (imageFile->name() == file.name())
+    // A file replaced since it was opened starts over, cachedGif still holds the old frames
+    GifCache &cache = GifCache::getInstance();
+    if (imageFile->name() == file.name() && cacheGeneration == cache.getGeneration())
     {
-      drawFrame();
+      if (cachedGif)
+        drawCachedFrame();
+      else
+        drawFrame();
       return;
     }
     else
     {
-      needNewFrame = true;
       file = *imageFile;
-      memset(lastFrame, 0, sizeof(lastFrame));
-      memset(gifPalette, 0, sizeof(gifPalette));
-      memset(lzwImageData, 0, sizeof(lzwImageData));
-      memset(imageData, 0, sizeof(imageData));
-      memset(imageDataBU, 0, sizeof(imageDataBU));
-      memset(stack, 0, sizeof(stack));
-      memset(suffix, 0, sizeof(suffix));
-      memset(prefix, 0, sizeof(prefix));
+      cacheGeneration = cache.getGeneration();
+      cachedGif = nullptr;
+      if (cache.isEnabled())
+      {
+        if (!cache.isRejected(file.name()))
+          cachedGif = cache.find(file.name());
+        if (!cachedGif && !cache.isRejected(file.name()))
+        {
+          cachedGif = decodeToCache(cache.getBudget());
+          if (!cachedGif || !cache.insert(cachedGif))
+          {
+            cache.reject(file.name());
+            cachedGif = nullptr;
+          }
+        }
+      }
+      if (cachedGif)
+      {
+        cachedFrame = 0;
+        cachedFrameTime = millis();
+        drawCachedFrame();
+        return;
+      }
+
+      needNewFrame = true;
+      resetDecoder();
       parseGifHeader();
       parseLogicalScreenDescriptor();
       parseGlobalColorTable();
@@ -63,7 +63,7 @@ public:
   ~TJpg_Decoder();
 
   static int jd_output(JDEC* jdec, void* bitmap, JRECT* jrect);
-  static unsigned int jd_input(JDEC* jdec, uint8_t* buf, unsigned int len);
+  static size_t jd_input(JDEC* jdec, uint8_t* buf, size_t len);
 
   void setJpgScale(uint8_t scale);
   void setCallback(SketchCallback sketchCallback);
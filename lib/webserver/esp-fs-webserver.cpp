@@ -12,6 +12,11 @@ WebServerClass *FSWebServer::getRequest()
     return webserver;
 }
 
+void FSWebServer::onFileChanged(FileChangedCallback fn)
+{
+    m_fileChangedCallback = fn;
+}
+
 void FSWebServer::run()
 {
     webserver->handleClient();
@@ -567,6 +572,7 @@ void FSWebServer::handleFileUpload()
         }
 
         DebugPrintf_P(PSTR("handleFileUpload Name: %s\n"), filename.c_str());
+        m_uploadPath = filename;
         m_uploadFile = m_filesystem->open(filename, "w");
         if (!m_uploadFile)
         {
@@ -593,6 +599,8 @@ void FSWebServer::handleFileUpload()
         if (m_uploadFile)
         {
             m_uploadFile.close();
+            if (m_fileChangedCallback)
+                m_fileChangedCallback(m_uploadPath);
         }
         DebugPrintf_P(PSTR("Upload: END, Size: %d\n"), upload.totalSize);
     }
@@ -856,6 +864,8 @@ void FSWebServer::handleFileDelete()
     {
         root.close();
         m_filesystem->remove(path);
+        if (m_fileChangedCallback)
+            m_fileChangedCallback(path);
         replyOK();
     }
     else
@@ -75,6 +75,8 @@ class FSWebServer
     // using CallbackF = std::function<void(void)>;
 
 public:
+    using FileChangedCallback = std::function<void(const String &path)>;
+
     WebServerClass *webserver;
 
     FSWebServer(fs::FS &fs, WebServerClass &server);
@@ -96,6 +98,9 @@ public:
 
     WebServerClass *getRequest();
 
+    // Called with the full path after a file was uploaded or deleted through /edit
+    void onFileChanged(FileChangedCallback fn);
+
 #ifdef INCLUDE_SETUP_HTM
 
 #define MIN_F -3.4028235E+38
@@ -307,6 +312,8 @@ private:
     DNSServer m_dnsServer;
     fs::FS *m_filesystem;
     File m_uploadFile;
+    String m_uploadPath;
+    FileChangedCallback m_fileChangedCallback = nullptr;
     bool m_fsOK = false;
     bool m_apmode = false;
     char *m_apWebpage = (char *)"/setup";
@@ -0,0 +1,66 @@
+#include "MQTTManager.h"
+#include "PeripheryManager.h"
+#include "MenuManager.h"
+
+// Stand-ins for the managers the emulator doesn't build. MQTT, sound, sensors and the
+// menu need hardware or a network, the display code only calls into them to report
+// state, so they accept every call and do nothing.
+
+MQTTManager_ &MQTTManager_::getInstance()
+{
+    static MQTTManager_ instance;
+    return instance;
+}
+
+MQTTManager_ &MQTTManager = MQTTManager.getInstance();
+
+void MQTTManager_::setup() {}
+void MQTTManager_::tick() {}
+void MQTTManager_::rawPublish(const char *prefix, const char *topic, const char *payload) {}
+void MQTTManager_::publish(const char *topic, const char *payload) {}
+void MQTTManager_::setCurrentApp(String app) {}
+void MQTTManager_::sendStats() {}
+void MQTTManager_::sendButton(byte btn, bool state) {}
+void MQTTManager_::setIndicatorState(uint8_t indicator, bool state, const CRGB &color) {}
+void MQTTManager_::beginPublish(const char *topic, unsigned int plength, boolean retained) {}
+void MQTTManager_::writePayload(const char *data, const uint16_t length) {}
+void MQTTManager_::endPublish() {}
+
+PeripheryManager_ &PeripheryManager_::getInstance()
+{
+    static PeripheryManager_ instance;
+    return instance;
+}
+
+PeripheryManager_ &PeripheryManager = PeripheryManager.getInstance();
+
+void PeripheryManager_::setup() {}
+void PeripheryManager_::tick() {}
+void PeripheryManager_::checkAlarms() {}
+void PeripheryManager_::playBootSound() {}
+bool PeripheryManager_::playFromFile(String file) { return false; }
+bool PeripheryManager_::playRTTTLString(String rtttl) { return false; }
+bool PeripheryManager_::parseSound(const char *json) { return false; }
+bool PeripheryManager_::isPlaying() { return false; }
+void PeripheryManager_::stopSound() {}
+
+const char *PeripheryManager_::readUptime()
+{
+    static char uptime[25];
+    sprintf(uptime, "%lu", millis() / 1000);
+    return uptime;
+}
+
+MenuManager_ &MenuManager_::getInstance()
+{
+    static MenuManager_ instance;
+    return instance;
+}
+
+MenuManager_ &MenuManager = MenuManager.getInstance();
+
+String MenuManager_::menutext() { return ""; }
+void MenuManager_::rightButton() {}
+void MenuManager_::leftButton() {}
+void MenuManager_::selectButton() {}
+void MenuManager_::selectButtonLong() {}
@@ -0,0 +1,707 @@
+// Headless emulator for the native environment. Boots the display like main.cpp does,
+// loads custom apps and notifications from JSON files and renders frames into the
+// framebuffer under a frozen clock, so the same arguments always give the same frames.
+// Prints one JSON line with the results to stdout. With --suite it runs the scenario
+// catalogue against the golden frames instead, see native/README.md.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "DisplayManager.h"
+#include "MatrixDisplayUi.h"
+#include "Globals.h"
+#include "effects.h"
+#include "GifPlayer.h"
+#include "Canvas.h"
+#include "Fonts/AwtrixFont.h"
+
+// Defined in headers only DisplayManager.cpp includes
+float getTextWidth(const char *text, byte textCase);
+uint32_t hashBytes(uint32_t hash, const void *data, size_t length);
+void TimeApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context);
+
+extern FastLED_NeoMatrix *matrix;
+extern MatrixDisplayUi *ui;
+extern GifPlayer gif;
+
+#define EMULATOR_EPOCH 1700000000 // 2023-11-14 22:13:20 UTC, a Tuesday
+#define EMULATOR_UPTIME 1000000   // µs, the UI treats a timestamp of 0 as never updated
+#define FRAME_BYTES (32 * 8 * 3)  // a frame as written by --dump, RGB row by row
+
+struct Options
+{
+    String data = "native/data";
+    uint32_t frames = 250;
+    String native = "time,date,temp,hum,bat";
+    String effect;
+    std::vector<std::pair<String, String>> customApps; // name, payload file
+    std::vector<String> notifications;                 // payload files
+    bool realtime = false;
+    bool show = false;
+    bool bench = false;
+    bool suite = false;
+    bool record = false;
+    String dump;
+    String scenarios = "native/scenarios.json";
+    String golden = "native/golden.json";
+    String frameDir = "native/frames";
+};
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: program [options]\n"
+            "  --data DIR           directory with the file system (default native/data)\n"
+            "  --frames N           frames to render, iterations per benchmark (default 250)\n"
+            "  --native LIST        native apps in the loop, e.g. time,date or none (default all)\n"
+            "  --effect NAME        background effect\n"
+            "  --custom NAME FILE   custom app from a JSON payload, may be repeated\n"
+            "  --notify FILE        notification from a JSON payload, may be repeated\n"
+            "  --realtime           follow the host clock instead of the frozen one\n"
+            "  --show               draw every frame to stderr with ANSI colors\n"
+            "  --bench              run the micro benchmarks instead of the display loop\n"
+            "  --dump FILE          write every frame to FILE as raw RGB\n"
+            "  --suite              run every scenario and compare it with the golden frames\n"
+            "  --record             with --suite, write the golden frames instead\n"
+            "  --scenarios FILE     scenario catalogue (default native/scenarios.json)\n"
+            "  --golden FILE        golden frames (default native/golden.json)\n"
+            "  --frame-dir DIR      reference frames and the frames of changed scenarios (default native/frames)\n");
+    exit(2);
+}
+
+static bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        String arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--data" && hasValue)
+            options.data = argv[++i];
+        else if (arg == "--frames" && hasValue)
+            options.frames = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--native" && hasValue)
+            options.native = argv[++i];
+        else if (arg == "--effect" && hasValue)
+            options.effect = argv[++i];
+        else if (arg == "--custom" && i + 2 < argc)
+        {
+            options.customApps.emplace_back(argv[i + 1], argv[i + 2]);
+            i += 2;
+        }
+        else if (arg == "--notify" && hasValue)
+            options.notifications.emplace_back(argv[++i]);
+        else if (arg == "--realtime")
+            options.realtime = true;
+        else if (arg == "--show")
+            options.show = true;
+        else if (arg == "--bench")
+            options.bench = true;
+        else if (arg == "--dump" && hasValue)
+            options.dump = argv[++i];
+        else if (arg == "--suite")
+            options.suite = true;
+        else if (arg == "--record")
+            options.record = true;
+        else if (arg == "--scenarios" && hasValue)
+            options.scenarios = argv[++i];
+        else if (arg == "--golden" && hasValue)
+            options.golden = argv[++i];
+        else if (arg == "--frame-dir" && hasValue)
+            options.frameDir = argv[++i];
+        else
+            return false;
+    }
+    return options.frames > 0 && (options.suite || !options.record);
+}
+
+static bool readFile(const String &path, String &content)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file)
+        return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str().c_str();
+    return true;
+}
+
+static bool hasItem(const String &list, const char *item)
+{
+    return ("," + list + ",").indexOf("," + String(item) + ",") >= 0;
+}
+
+static void printFrame(bool last)
+{
+    std::string out;
+    char cell[32];
+    for (int y = 0; y < 8; y++)
+    {
+        for (int x = 0; x < 32; x++)
+        {
+            CRGB color = DisplayManager.getPixelColor(x, y);
+            snprintf(cell, sizeof(cell), "\x1b[48;2;%u;%u;%um  ", color.r, color.g, color.b);
+            out += cell;
+        }
+        out += "\x1b[0m\n";
+    }
+    if (!last)
+        out += "\x1b[8A";
+    fputs(out.c_str(), stderr);
+}
+
+static void dumpFrame(FILE *file)
+{
+    uint8_t frame[FRAME_BYTES];
+    uint8_t *pixel = frame;
+    for (int y = 0; y < 8; y++)
+    {
+        for (int x = 0; x < 32; x++)
+        {
+            CRGB color = DisplayManager.getPixelColor(x, y);
+            *pixel++ = color.r;
+            *pixel++ = color.g;
+            *pixel++ = color.b;
+        }
+    }
+    fwrite(frame, 1, sizeof(frame), file);
+}
+
+static void emit(JsonDocument &doc)
+{
+    String json;
+    serializeJson(doc, json);
+    puts(json.c_str());
+    fflush(stdout);
+}
+
+// Boots the display like setup() in main.cpp, without network, sound and sensors
+static bool boot(const Options &options)
+{
+    if (!LittleFS.begin(false, options.data.c_str()))
+    {
+        fprintf(stderr, "Can't open %s\n", options.data.c_str());
+        return false;
+    }
+    loadSettings();
+    setenv("TZ", NTP_TZ.c_str(), 1); // what configTzTime does on the device
+    tzset();
+
+    // Fixed readings, so the sensor apps show the same on every run
+    SENSOR_READING = true;
+    CURRENT_TEMP = 21.5;
+    CURRENT_HUM = 45;
+    BATTERY_PERCENT = 87;
+    SHOW_TIME = hasItem(options.native, "time");
+    SHOW_DATE = hasItem(options.native, "date");
+    SHOW_TEMP = hasItem(options.native, "temp");
+    SHOW_HUM = hasItem(options.native, "hum");
+    SHOW_BAT = hasItem(options.native, "bat");
+
+    DisplayManager.setup();
+    DisplayManager.loadNativeApps();
+    DisplayManager.setBrightness(BRIGHTNESS);
+
+    if (options.effect.length())
+    {
+        int effect = getEffectIndex(options.effect);
+        if (effect < 0)
+        {
+            fprintf(stderr, "Unknown effect %s\n", options.effect.c_str());
+            return false;
+        }
+        ui->setBackgroundEffect(effect);
+    }
+
+    String payload;
+    for (const auto &app : options.customApps)
+    {
+        if (!readFile(app.second, payload) || !DisplayManager.generateCustomPage(app.first, payload.c_str(), true))
+        {
+            fprintf(stderr, "Can't load custom app %s from %s\n", app.first.c_str(), app.second.c_str());
+            return false;
+        }
+    }
+    for (const auto &file : options.notifications)
+    {
+        if (!readFile(file, payload) || !DisplayManager.generateNotification(1, payload.c_str()))
+        {
+            fprintf(stderr, "Can't load notification from %s\n", file.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static void waitForOutput()
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (FastLED.getShowCount() < DisplayManager.framesShown && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+// Renders the given number of frames through the regular display loop and reports a
+// hash over all of them together with the frame counters and the throughput
+static bool runDisplay(const Options &options)
+{
+    FILE *dump = nullptr;
+    if (options.dump.length() && !(dump = fopen(options.dump.c_str(), "wb")))
+    {
+        fprintf(stderr, "Can't write frames to %s\n", options.dump.c_str());
+        return false;
+    }
+    uint32_t hash = 2166136261;
+    uint32_t rendered = 0;
+    uint32_t frameInterval = 1000000L / MATRIX_FPS;
+    float elapsed = 0; // µs spent in tick(), without the waiting and drawing around it
+    while (rendered < options.frames)
+    {
+        auto start = std::chrono::steady_clock::now();
+        DisplayManager.tick();
+        elapsed += std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+        uint32_t frames = DisplayManager.framesShown + DisplayManager.framesSkipped;
+        if (frames != rendered)
+        {
+            rendered = frames;
+            // On the device the output task keeps up with the frame rate, here it has to
+            // be waited for, or frames would pile up and be sent as one
+            if (!options.realtime)
+                waitForOutput();
+            hash = hashBytes(hash, DisplayManager.getLeds(), 256 * sizeof(CRGB));
+            if (options.show)
+                printFrame(rendered == options.frames);
+            if (dump)
+                dumpFrame(dump);
+        }
+        if (options.realtime)
+            delay(1);
+        else
+            hostClockAdvance(frameInterval);
+    }
+    waitForOutput();
+    if (dump && fclose(dump) != 0)
+        return false;
+
+    DynamicJsonDocument doc(512);
+    char hex[9];
+    snprintf(hex, sizeof(hex), "%08x", hash);
+    doc["frames"] = rendered;
+    doc["hash"] = hex;
+    doc["shown"] = DisplayManager.framesShown;
+    doc["skipped"] = DisplayManager.framesSkipped;
+    doc["driver_shows"] = FastLED.getShowCount();
+    doc["us_per_frame"] = elapsed / rendered;
+    doc["fps"] = options.realtime ? ui->getFramePacing().fps : rendered * 1000000.0f / elapsed;
+    emit(doc);
+    return true;
+}
+
+static volatile uint32_t sink;
+
+// µs per call of the given function, averaged over count calls
+template <typename F>
+static float usPer(uint32_t count, F function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; i++)
+        function(i);
+    return std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+static void emitBench(const char *name, const char *before, float beforeUs, const char *after, float afterUs, const char *subject = nullptr)
+{
+    StaticJsonDocument<256> doc;
+    doc["bench"] = name;
+    if (subject)
+        doc["subject"] = subject;
+    doc[before] = beforeUs;
+    doc[after] = afterUs;
+    doc["speedup"] = afterUs > 0 ? beforeUs / afterUs : 0;
+    emit(doc);
+}
+
+// Streaming every frame out of the file compared to playback from the GIF cache
+static void benchGifPlayback(uint32_t count)
+{
+    GifCache &cache = GifCache::getInstance();
+    size_t budget = cache.getBudget();
+    File dir = LittleFS.open("/ICONS");
+    for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile())
+    {
+        String path = "/ICONS/" + String(entry.name());
+        if (!path.endsWith(".gif"))
+            continue;
+        auto play = [&](size_t cacheBudget)
+        {
+            cache.setBudget(cacheBudget);
+            cache.invalidate(entry.name());
+            std::unique_ptr<GifPlayer> player(new GifPlayer());
+            player->setMatrix(matrix);
+            File file = LittleFS.open(path);
+            return usPer(count, [&](uint32_t)
+                         {
+                             hostClockAdvance(20000);
+                             matrix->clear();
+                             player->playGif(0, 0, &file); });
+        };
+        float streamed = play(0);
+        float cached = play(std::max<size_t>(budget, 65536));
+        emitBench("gif_playback", "stream_us", streamed, "cache_us", cached, entry.name());
+    }
+    cache.setBudget(budget);
+}
+
+// The former std::map based text measurement compared to the glyph advance table
+static void benchTextWidth(uint32_t count)
+{
+    std::map<char, uint16_t> charMap;
+    for (uint16_t i = 0; i < sizeof(AwtrixFontGlyphs) / sizeof(GFXglyph); i++)
+        charMap[(char)(AwtrixFont.first + i)] = AwtrixFontGlyphs[i].xAdvance;
+    const char *texts[] = {"12:34:56", "21.5°C", "Hello from the AWTRIX emulator", "ABCDEFGHIJKLMNOPQRSTUVWXYZ 0123456789"};
+    float before = usPer(count, [&](uint32_t i)
+                         {
+                             float width = 0;
+                             for (const char *c = texts[i % 4]; *c != '\0'; ++c)
+                             {
+                                 char current = toupper(*c);
+                                 width += charMap.count(current) > 0 ? charMap[current] : 4;
+                             }
+                             sink += width; });
+    float after = usPer(count, [&](uint32_t i)
+                        { sink += getTextWidth(texts[i % 4], 1); });
+    emitBench("text_width", "map_us", before, "table_us", after);
+}
+
+// applyGamma_video per channel compared to the lookup table of gammaCorrection
+static void benchGamma(uint32_t count)
+{
+    CRGB *leds = DisplayManager.getLeds();
+    CRGB gradient[256];
+    for (int i = 0; i < 256; i++)
+        gradient[i] = CRGB(i, 255 - i, (i * 7) & 0xFF);
+    float gamma = GAMMA;
+    GAMMA = 2.5;
+    float before = usPer(count, [&](uint32_t)
+                         {
+                             memcpy(leds, gradient, sizeof(gradient));
+                             uint8_t *channel = (uint8_t *)leds;
+                             for (int i = 0; i < 256 * 3; i++)
+                                 channel[i] = applyGamma_video(channel[i], GAMMA); });
+    float after = usPer(count, [&](uint32_t)
+                        {
+                            memcpy(leds, gradient, sizeof(gradient));
+                            DisplayManager.gammaCorrection(); });
+    GAMMA = gamma;
+    emitBench("gamma", "pow_us", before, "table_us", after);
+}
+
+// Filling the screen pixel by pixel through drawPixel compared to the canvas
+static void benchCanvas(uint32_t count)
+{
+    Canvas &canvas = Canvas::getInstance();
+    float before = usPer(count, [&](uint32_t i)
+                         {
+                             for (int16_t y = 0; y < 8; y++)
+                                 for (int16_t x = 0; x < 32; x++)
+                                     matrix->drawPixel(x, y, CRGB(x * 8, y * 32, i)); });
+    float after = usPer(count, [&](uint32_t i)
+                        {
+                            for (int16_t y = 0; y < 8; y++)
+                                for (int16_t x = 0; x < 32; x++)
+                                    canvas.setPixel(x, y, CRGB(x * 8, y * 32, i)); });
+    emitBench("full_screen_fill", "draw_pixel_us", before, "canvas_us", after);
+}
+
+// A frame of the clock app when the second changed compared to one within the same second
+static void benchClockApp(uint32_t count)
+{
+    MatrixDisplayUiState *state = ui->getUiState();
+    float changed = usPer(count, [&](uint32_t)
+                          {
+                              hostClockAdvance(1000000);
+                              matrix->clear();
+                              TimeApp(matrix, state, 0, 0, false, false, &gif, nullptr); });
+    float same = usPer(count, [&](uint32_t)
+                       {
+                           matrix->clear();
+                           TimeApp(matrix, state, 0, 0, false, false, &gif, nullptr); });
+    emitBench("clock_app", "new_second_us", changed, "same_second_us", same);
+}
+
+// A run of the emulator with its own arguments. Every scenario runs in a fresh process,
+// the display keeps its apps, caches and counters for the lifetime of the program.
+struct Scenario
+{
+    String name;
+    std::vector<String> args;
+};
+
+static String quote(const String &arg)
+{
+    String quoted = "'";
+    for (char c : arg)
+    {
+        if (c == '\'')
+            quoted += "'\\''";
+        else
+            quoted += c;
+    }
+    return quoted + "'";
+}
+
+static String fileStem(const String &path)
+{
+    String name = path.substring(path.lastIndexOf('/') + 1);
+    int dot = name.lastIndexOf('.');
+    return dot > 0 ? name.substring(0, dot) : name;
+}
+
+// Reads the catalogue and adds a scenario for each entry of effects[], so a new effect
+// shows up without touching the catalogue. Payload paths are relative to the catalogue.
+static bool loadScenarios(const String &path, std::vector<Scenario> &scenarios)
+{
+    String content;
+    DynamicJsonDocument doc(16384);
+    if (!readFile(path, content) || deserializeJson(doc, content))
+    {
+        fprintf(stderr, "Can't read scenarios from %s\n", path.c_str());
+        return false;
+    }
+    int slash = path.lastIndexOf('/');
+    String dir = slash >= 0 ? path.substring(0, slash + 1) : "";
+    uint32_t frames = doc["frames"] | 250;
+
+    for (JsonObject entry : doc["scenarios"].as<JsonArray>())
+    {
+        Scenario scenario;
+        scenario.name = entry["name"].as<String>();
+        scenario.args = {"--frames", String(entry["frames"] | frames), "--native", entry["native"] | "none"};
+        if (entry.containsKey("effect"))
+            scenario.args.insert(scenario.args.end(), {"--effect", entry["effect"].as<String>()});
+        for (JsonVariant file : entry["custom"].as<JsonArray>())
+            scenario.args.insert(scenario.args.end(), {"--custom", fileStem(file.as<String>()), dir + file.as<String>()});
+        for (JsonVariant file : entry["notify"].as<JsonArray>())
+            scenario.args.insert(scenario.args.end(), {"--notify", dir + file.as<String>()});
+        scenarios.push_back(scenario);
+    }
+    for (uint8_t i = 0; i < effectsCount; i++)
+        scenarios.push_back({"effect/" + effects[i].name, {"--frames", String(frames), "--native", "none", "--effect", effects[i].name}});
+    return true;
+}
+
+// Runs the scenario in a child process, which writes its frames to dump, and parses the JSON line it prints
+static bool runScenario(const char *program, const Options &options, const Scenario &scenario, const String &dump, JsonDocument &result)
+{
+    String command = quote(program) + " --data " + quote(options.data) + " --dump " + quote(dump);
+    for (const String &arg : scenario.args)
+        command += " " + quote(arg);
+    command += " 2>/dev/null";
+
+    FILE *child = popen(command.c_str(), "r");
+    if (!child)
+        return false;
+    char line[1024];
+    bool read = fgets(line, sizeof(line), child) != nullptr;
+    int status = pclose(child);
+    return read && status == 0 && !deserializeJson(result, line) && result.containsKey("hash");
+}
+
+static bool readFrames(const String &path, std::vector<uint8_t> &frames)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file)
+        return false;
+    frames.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return frames.size() % FRAME_BYTES == 0;
+}
+
+static String frameHash(const uint8_t *frame)
+{
+    char hex[9];
+    snprintf(hex, sizeof(hex), "%08x", hashBytes(2166136261, frame, FRAME_BYTES));
+    return hex;
+}
+
+// Golden frames list one hash per frame, a run of equal frames as "hash*count"
+static std::vector<String> expandFrameHashes(JsonArrayConst runs)
+{
+    std::vector<String> hashes;
+    for (JsonVariantConst run : runs)
+    {
+        String entry = run.as<String>();
+        int star = entry.indexOf('*');
+        uint32_t count = star > 0 ? entry.substring(star + 1).toInt() : 1;
+        hashes.insert(hashes.end(), count, star > 0 ? entry.substring(0, star) : entry);
+    }
+    return hashes;
+}
+
+static String compactFrameHashes(const std::vector<String> &hashes)
+{
+    String runs;
+    for (size_t i = 0; i < hashes.size();)
+    {
+        size_t count = 1;
+        while (i + count < hashes.size() && hashes[i + count] == hashes[i])
+            count++;
+        runs += (runs.length() ? ", \"" : "\"") + hashes[i] + (count > 1 ? "*" + String(count) : "") + "\"";
+        i += count;
+    }
+    return "[" + runs + "]";
+}
+
+static bool writePpm(const String &path, const uint8_t *frame)
+{
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << "P6\n32 8\n255\n";
+    file.write((const char *)frame, FRAME_BYTES);
+    return file.good();
+}
+
+// Renders every scenario of the catalogue and compares the hash of every frame and the
+// shown frame count with the golden frames. Prints one JSON line per scenario and a
+// summary, and fails if any scenario changed, is missing from the golden frames or
+// didn't run. The first changed frame of a scenario is written to the frame directory
+// as PPM, next to the golden one if its reference frames are there. With record the
+// golden frames and the reference frames are written from this run instead.
+static int runSuite(const char *program, const Options &options)
+{
+    std::vector<Scenario> scenarios;
+    if (!loadScenarios(options.scenarios, scenarios))
+        return 1;
+    String content;
+    if (!options.record)
+        readFile(options.golden, content);
+    DynamicJsonDocument golden(content.length() * 4 + 1024); // a slot and a copy for every hash of about 12 characters
+    if (!options.record && (!content.length() || deserializeJson(golden, content)))
+        fprintf(stderr, "Can't read golden frames from %s, every scenario is new\n", options.golden.c_str());
+    mkdir(options.frameDir.c_str(), 0755);
+    String dump = options.frameDir + "/run.rgb";
+
+    std::map<String, uint32_t> counts;
+    String recorded = "{\n";
+    for (size_t i = 0; i < scenarios.size(); i++)
+    {
+        const Scenario &scenario = scenarios[i];
+        DynamicJsonDocument result(512);
+        StaticJsonDocument<1024> doc;
+        doc["scenario"] = scenario.name;
+        const char *status;
+        std::vector<uint8_t> frames;
+        if (!runScenario(program, options, scenario, dump, result) || !readFrames(dump, frames))
+        {
+            status = "failed";
+        }
+        else
+        {
+            uint32_t shown = result["shown"];
+            doc["frames"] = result["frames"];
+            doc["fps"] = result["fps"];
+            doc["us_per_frame"] = result["us_per_frame"];
+            doc["hash"] = result["hash"];
+            doc["shown"] = shown;
+
+            std::vector<String> hashes;
+            for (size_t f = 0; f < frames.size(); f += FRAME_BYTES)
+                hashes.push_back(frameHash(&frames[f]));
+            String fileName = scenario.name;
+            fileName.replace("/", "_");
+            String reference = options.frameDir + "/" + fileName + ".rgb";
+
+            JsonObject expected = golden[scenario.name];
+            std::vector<String> expectedHashes = expandFrameHashes(expected["frames"]);
+            size_t changed = 0;
+            while (changed < hashes.size() && changed < expectedHashes.size() && hashes[changed] == expectedHashes[changed])
+                changed++;
+            if (options.record)
+            {
+                status = rename(dump.c_str(), reference.c_str()) == 0 ? "recorded" : "failed";
+            }
+            else if (expected.isNull())
+            {
+                status = "new";
+            }
+            else if (changed == hashes.size() && changed == expectedHashes.size() && expected["shown"] == shown)
+            {
+                status = "ok";
+            }
+            else
+            {
+                status = "changed";
+                doc["expected_frames"] = expectedHashes.size();
+                doc["expected_shown"] = expected["shown"];
+                if (changed < hashes.size() || changed < expectedHashes.size())
+                    doc["changed_frame"] = changed;
+
+                String path = options.frameDir + "/" + fileName + "-" + String(changed);
+                if (changed < hashes.size() && writePpm(path + "-actual.ppm", &frames[changed * FRAME_BYTES]))
+                    doc["actual_ppm"] = path + "-actual.ppm";
+                // The reference frames are only used if they are the ones golden.json was recorded from
+                std::vector<uint8_t> referenceFrames;
+                if (changed < expectedHashes.size() && readFrames(reference, referenceFrames) && referenceFrames.size() > changed * FRAME_BYTES &&
+                    frameHash(&referenceFrames[changed * FRAME_BYTES]) == expectedHashes[changed] && writePpm(path + "-expected.ppm", &referenceFrames[changed * FRAME_BYTES]))
+                    doc["expected_ppm"] = path + "-expected.ppm";
+            }
+
+            recorded += "  \"" + scenario.name + "\": {\"shown\": " + String(shown) + ", \"frames\": " + compactFrameHashes(hashes) + "}";
+            recorded += i + 1 < scenarios.size() ? ",\n" : "\n";
+        }
+        doc["status"] = status;
+        counts[status]++;
+        emit(doc);
+    }
+    recorded += "}\n";
+    remove(dump.c_str());
+
+    StaticJsonDocument<256> summary;
+    summary["scenarios"] = scenarios.size();
+    for (const auto &count : counts)
+        summary[count.first] = count.second;
+    bool passed = counts["recorded"] + counts["ok"] == scenarios.size();
+    if (options.record && passed)
+    {
+        std::ofstream file(options.golden.c_str(), std::ios::binary);
+        file << recorded.c_str();
+        passed = file.good();
+        summary["golden"] = options.golden;
+    }
+    summary["passed"] = passed;
+    emit(summary);
+    return passed ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        usage();
+    if (options.suite)
+        return runSuite(argv[0], options);
+    if (!options.realtime || options.bench)
+        hostClockFreeze(EMULATOR_EPOCH, EMULATOR_UPTIME);
+    if (!boot(options))
+        return 1;
+
+    bool ok = true;
+    if (options.bench)
+    {
+        benchGifPlayback(options.frames);
+        benchTextWidth(options.frames);
+        benchGamma(options.frames);
+        benchCanvas(options.frames);
+        benchClockApp(options.frames);
+    }
+    else
+    {
+        ok = runDisplay(options);
+    }
+    fflush(stdout);
+    _exit(ok ? 0 : 1); // the output task never returns, don't wait for it
+}
@@ -0,0 +1,222 @@
+#include "Arduino.h"
+#include "WiFi.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+static const std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+static std::atomic<bool> clockFrozen(false);
+static std::atomic<int64_t> frozenMicros(0);
+static time_t frozenEpoch = 0;
+
+static int64_t hostMicros()
+{
+    if (clockFrozen)
+        return frozenMicros;
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - clockStart).count();
+}
+
+void hostClockFreeze(time_t epoch, int64_t uptime)
+{
+    frozenMicros = uptime;
+    frozenEpoch = epoch - uptime / 1000000;
+    clockFrozen = true;
+}
+
+void hostClockAdvance(uint32_t us)
+{
+    frozenMicros += us;
+}
+
+bool hostClockFrozen()
+{
+    return clockFrozen;
+}
+
+int64_t esp_timer_get_time()
+{
+    return hostMicros();
+}
+
+unsigned long millis()
+{
+    return hostMicros() / 1000;
+}
+
+unsigned long micros()
+{
+    return hostMicros();
+}
+
+void delay(uint32_t ms)
+{
+    if (clockFrozen)
+        hostClockAdvance(ms * 1000);
+    else
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    if (clockFrozen)
+        hostClockAdvance(us);
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+// Linked in place of time() with -Wl,--wrap=time, so the wall clock freezes with the rest
+extern "C" time_t __real_time(time_t *t);
+
+extern "C" time_t __wrap_time(time_t *t)
+{
+    if (!clockFrozen)
+        return __real_time(t);
+    time_t now = frozenEpoch + frozenMicros / 1000000;
+    if (t)
+        *t = now;
+    return now;
+}
+
+// xorshift32, seeded with a constant so runs repeat unless randomSeed() is called
+static uint32_t randomState = 2463534242UL;
+
+static uint32_t nextRandom()
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+long random(long howbig)
+{
+    if (howbig <= 0)
+        return 0;
+    return nextRandom() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig)
+        return howsmall;
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed != 0)
+        randomState = seed;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    const long run = in_max - in_min;
+    if (run == 0)
+        return -1; // the core returns -1 as well instead of dividing by zero
+    const long rise = out_max - out_min;
+    const long delta = x - in_min;
+    return (delta * rise) / run + out_min;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {}
+
+int digitalRead(uint8_t pin)
+{
+    return HIGH;
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+    return 0;
+}
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t length = strlen(src);
+    if (size)
+    {
+        size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+
+size_t strlcat(char *dst, const char *src, size_t size)
+{
+    size_t used = strnlen(dst, size);
+    if (used == size)
+        return size + strlen(src);
+    return used + strlcpy(dst + used, src, size - used);
+}
+#endif
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return fwrite(&c, 1, 1, stderr);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stderr);
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    return 0;
+}
+
+uint32_t EspClass::getHeapSize()
+{
+    return 0;
+}
+
+uint32_t EspClass::getMinFreeHeap()
+{
+    return 0;
+}
+
+uint32_t EspClass::getMaxAllocHeap()
+{
+    return 0;
+}
+
+const char *EspClass::getSdkVersion()
+{
+    return "native";
+}
+
+void EspClass::restart()
+{
+    fflush(stdout);
+    exit(1);
+}
+
+bool IPAddress::fromString(const char *address)
+{
+    unsigned a, b, c, d;
+    char tail;
+    if (sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+        return false;
+    *this = IPAddress(a, b, c, d);
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(buf);
+}
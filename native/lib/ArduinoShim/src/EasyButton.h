@@ -0,0 +1,30 @@
+#ifndef _EasyButton_h
+#define _EasyButton_h
+
+#include "Arduino.h"
+
+// Buttons are never pressed on the host
+class EasyButton
+{
+public:
+    typedef void (*callback_t)();
+
+    EasyButton(uint8_t pin, uint32_t debounce_time = 35, bool pullup_enable = true, bool active_low = true) {}
+    void begin() {}
+    bool read()
+    {
+        return false;
+    }
+    void onPressed(callback_t callback) {}
+    void onPressedFor(uint32_t duration, callback_t callback) {}
+    bool isPressed()
+    {
+        return false;
+    }
+    bool isReleased()
+    {
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef ESP_H
+#define ESP_H
+
+#include <stdint.h>
+
+class EspClass
+{
+public:
+    // Heap statistics of the host say nothing about the device, these report 0
+    uint32_t getFreeHeap();
+    uint32_t getHeapSize();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    const char *getSdkVersion();
+    // Ends the process, there is nothing to restart into
+    [[noreturn]] void restart();
+};
+
+extern EspClass ESP;
+
+#endif
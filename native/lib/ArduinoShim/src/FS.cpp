@@ -0,0 +1,250 @@
+#include "FS.h"
+#include "LittleFS.h"
+#include "SD.h"
+#include "SPIFFS.h"
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace fs
+{
+
+struct FileImpl
+{
+    std::string hostPath;
+    std::string path;
+    FILE *stream = nullptr;
+    size_t length = 0;
+    bool directory = false;
+    std::vector<std::string> entries;
+    size_t nextEntry = 0;
+    const char *mode = FILE_READ;
+
+    ~FileImpl()
+    {
+        if (stream)
+            fclose(stream);
+    }
+};
+
+static FileImplPtr openHostFile(const std::string &hostPath, const std::string &path, const char *mode)
+{
+    struct stat info;
+    bool found = stat(hostPath.c_str(), &info) == 0;
+    FileImplPtr impl = std::make_shared<FileImpl>();
+    impl->hostPath = hostPath;
+    impl->path = path;
+    impl->mode = mode;
+    if (found && S_ISDIR(info.st_mode))
+    {
+        impl->directory = true;
+        DIR *dir = opendir(hostPath.c_str());
+        if (!dir)
+            return FileImplPtr();
+        while (dirent *entry = readdir(dir))
+        {
+            if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, ".."))
+                impl->entries.push_back(entry->d_name);
+        }
+        closedir(dir);
+        // readdir order depends on the host file system, LittleFS lists by name
+        std::sort(impl->entries.begin(), impl->entries.end());
+        return impl;
+    }
+    const char *hostMode = mode[0] == 'w' ? "wb" : mode[0] == 'a' ? "ab" : "rb";
+    if (mode[0] == 'r' && !found)
+        return FileImplPtr();
+    impl->stream = fopen(hostPath.c_str(), hostMode);
+    if (!impl->stream)
+        return FileImplPtr();
+    impl->length = found && mode[0] != 'w' ? info.st_size : 0;
+    return impl;
+}
+
+size_t File::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    if (!_p || !_p->stream || _p->mode[0] == 'r')
+        return 0;
+    size_t written = fwrite(buf, 1, size, _p->stream);
+    long pos = ftell(_p->stream);
+    if (pos > (long)_p->length)
+        _p->length = pos;
+    return written;
+}
+
+int File::available()
+{
+    if (!_p || !_p->stream)
+        return 0;
+    return _p->length - position();
+}
+
+int File::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek()
+{
+    if (!_p || !_p->stream)
+        return -1;
+    int c = fgetc(_p->stream);
+    if (c != EOF)
+        ungetc(c, _p->stream);
+    return c == EOF ? -1 : c;
+}
+
+void File::flush()
+{
+    if (_p && _p->stream)
+        fflush(_p->stream);
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+    if (!_p || !_p->stream)
+        return 0;
+    return fread(buf, 1, size, _p->stream);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    if (!_p || !_p->stream)
+        return false;
+    int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+    return fseek(_p->stream, pos, whence) == 0;
+}
+
+size_t File::position() const
+{
+    if (!_p || !_p->stream)
+        return 0;
+    return ftell(_p->stream);
+}
+
+size_t File::size() const
+{
+    return _p ? _p->length : 0;
+}
+
+void File::close()
+{
+    _p.reset();
+}
+
+File::operator bool() const
+{
+    return !!_p;
+}
+
+time_t File::getLastWrite()
+{
+    struct stat info;
+    if (!_p || stat(_p->hostPath.c_str(), &info) != 0)
+        return 0;
+    return info.st_mtime;
+}
+
+const char *File::path() const
+{
+    return _p ? _p->path.c_str() : nullptr;
+}
+
+const char *File::name() const
+{
+    if (!_p)
+        return nullptr;
+    size_t slash = _p->path.rfind('/');
+    return _p->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+boolean File::isDirectory(void)
+{
+    return _p && _p->directory;
+}
+
+File File::openNextFile(const char *mode)
+{
+    if (!_p || !_p->directory || _p->nextEntry >= _p->entries.size())
+        return File();
+    const std::string &entry = _p->entries[_p->nextEntry++];
+    std::string path = _p->path == "/" ? "/" + entry : _p->path + "/" + entry;
+    return File(openHostFile(_p->hostPath + "/" + entry, path, mode));
+}
+
+void File::rewindDirectory(void)
+{
+    if (_p)
+        _p->nextEntry = 0;
+}
+
+bool FS::mount(const char *basePath)
+{
+    struct stat info;
+    if (!basePath || stat(basePath, &info) != 0 || !S_ISDIR(info.st_mode))
+        return false;
+    root = basePath;
+    while (root.size() > 1 && root.back() == '/')
+        root.pop_back();
+    return true;
+}
+
+void FS::unmount()
+{
+    root.clear();
+}
+
+std::string FS::hostPath(const char *path) const
+{
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/')
+        p = "/" + p;
+    return root + p;
+}
+
+File FS::open(const char *path, const char *mode, const bool create)
+{
+    if (!mounted() || !path || path[0] != '/')
+        return File();
+    return File(openHostFile(hostPath(path), path, mode));
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat info;
+    return mounted() && stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    return mounted() && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *pathFrom, const char *pathTo)
+{
+    return mounted() && ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path)
+{
+    return mounted() && (::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST);
+}
+
+bool FS::rmdir(const char *path)
+{
+    return mounted() && ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+} // namespace fs
+
+fs::LittleFSFS LittleFS;
+fs::SPIFFSFS SPIFFS;
+fs::SDFS SD;
@@ -0,0 +1,140 @@
+#include "Arduino.h"
+#include <pthread.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct HostTask
+{
+    TaskFunction_t code;
+    void *parameter;
+    std::mutex lock;
+    std::condition_variable notified;
+    uint32_t notifications = 0;
+};
+
+struct HostSemaphore
+{
+    std::mutex lock;
+    std::condition_variable given;
+    uint32_t count;
+};
+
+static thread_local HostTask *currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackDepth, void *parameter,
+                                   UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreId)
+{
+    HostTask *task = new HostTask();
+    task->code = code;
+    task->parameter = parameter;
+    if (createdTask)
+        *createdTask = task;
+    std::thread([task]()
+                {
+                    currentTask = task;
+                    task->code(task->parameter); })
+        .detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint32_t stackDepth, void *parameter,
+                       UBaseType_t priority, TaskHandle_t *createdTask)
+{
+    return xTaskCreatePinnedToCore(code, name, stackDepth, parameter, priority, createdTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == nullptr || task == currentTask)
+        pthread_exit(nullptr);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks * portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return currentTask;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+    HostTask *task = currentTask;
+    if (!task)
+        return 0;
+    std::unique_lock<std::mutex> guard(task->lock);
+    auto pending = [task]()
+    {
+        return task->notifications > 0;
+    };
+    if (ticksToWait == portMAX_DELAY)
+        task->notified.wait(guard, pending);
+    else
+        task->notified.wait_for(guard, std::chrono::milliseconds(ticksToWait), pending);
+    uint32_t value = task->notifications;
+    if (value)
+        task->notifications = clearCountOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    if (!task)
+        return pdFAIL;
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->notified.notify_one();
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    HostSemaphore *semaphore = new HostSemaphore();
+    semaphore->count = 1;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    HostSemaphore *semaphore = new HostSemaphore();
+    semaphore->count = 0;
+    return semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> guard(semaphore->lock);
+    auto available = [semaphore]()
+    {
+        return semaphore->count > 0;
+    };
+    if (ticksToWait == portMAX_DELAY)
+        semaphore->given.wait(guard, available);
+    else if (!semaphore->given.wait_for(guard, std::chrono::milliseconds(ticksToWait), available))
+        return pdFALSE;
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    {
+        std::lock_guard<std::mutex> guard(semaphore->lock);
+        if (semaphore->count)
+            return pdFALSE;
+        semaphore->count = 1;
+    }
+    semaphore->given.notify_one();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
@@ -0,0 +1,40 @@
+#ifndef HTTPClient_H_
+#define HTTPClient_H_
+
+#include "Arduino.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+// Every request fails to connect, like on a device without a network
+class HTTPClient
+{
+public:
+    bool begin(String url)
+    {
+        return true;
+    }
+    void end() {}
+    void addHeader(const String &name, const String &value) {}
+    int GET()
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    int POST(String payload)
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    int POST(uint8_t *payload, size_t size)
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    String getString()
+    {
+        return String();
+    }
+    int getSize()
+    {
+        return -1;
+    }
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include "Stream.h"
+
+// Serial output goes to stderr, so stdout stays free for the emulator's results
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud) {}
+    void end() {}
+    int available() override
+    {
+        return 0;
+    }
+    int read() override
+    {
+        return -1;
+    }
+    int peek() override
+    {
+        return -1;
+    }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    operator bool() const
+    {
+        return true;
+    }
+};
+
+extern HardwareSerial Serial;
+
+#endif
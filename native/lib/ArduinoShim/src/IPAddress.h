@@ -0,0 +1,40 @@
+#ifndef IPAddress_h
+#define IPAddress_h
+
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress
+{
+private:
+    uint8_t bytes[4] = {0, 0, 0, 0};
+
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+    IPAddress(uint32_t address)
+    {
+        for (uint8_t i = 0; i < 4; i++)
+            bytes[i] = address >> (8 * i);
+    }
+    operator uint32_t() const
+    {
+        return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+    }
+    uint8_t operator[](int index) const
+    {
+        return bytes[index];
+    }
+    uint8_t &operator[](int index)
+    {
+        return bytes[index];
+    }
+    bool fromString(const char *address);
+    bool fromString(const String &address)
+    {
+        return fromString(address.c_str());
+    }
+    String toString() const;
+};
+
+#endif
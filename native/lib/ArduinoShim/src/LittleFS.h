@@ -0,0 +1,42 @@
+#ifndef _LITTLEFS_H_
+#define _LITTLEFS_H_
+
+#include "FS.h"
+
+namespace fs
+{
+
+class LittleFSFS : public FS
+{
+public:
+    // basePath names the host directory with the files. Mounting twice keeps the
+    // first directory, so a runner can mount its data before the firmware does.
+    bool begin(bool formatOnFail = false, const char *basePath = "data", uint8_t maxOpenFiles = 10,
+               const char *partitionLabel = "spiffs")
+    {
+        return mounted() || mount(basePath);
+    }
+    // Never wipes a host directory
+    bool format()
+    {
+        return false;
+    }
+    size_t totalBytes()
+    {
+        return 0;
+    }
+    size_t usedBytes()
+    {
+        return 0;
+    }
+    void end()
+    {
+        unmount();
+    }
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif
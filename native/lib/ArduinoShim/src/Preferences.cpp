@@ -0,0 +1,95 @@
+#include "Preferences.h"
+
+static std::map<std::string, std::map<std::string, std::string>> namespaces;
+
+bool Preferences::begin(const char *name, bool readOnly, const char *partition_label)
+{
+    values = &namespaces[name];
+    this->readOnly = readOnly;
+    return true;
+}
+
+void Preferences::end()
+{
+    values = nullptr;
+}
+
+bool Preferences::clear()
+{
+    if (!values || readOnly)
+        return false;
+    values->clear();
+    return true;
+}
+
+bool Preferences::remove(const char *key)
+{
+    if (!values || readOnly)
+        return false;
+    return values->erase(key) > 0;
+}
+
+bool Preferences::isKey(const char *key)
+{
+    return values && values->count(key);
+}
+
+size_t Preferences::putBool(const char *key, bool value)
+{
+    return putUInt(key, value);
+}
+
+size_t Preferences::putUInt(const char *key, uint32_t value)
+{
+    if (!values || readOnly)
+        return 0;
+    (*values)[key] = std::to_string(value);
+    return sizeof(value);
+}
+
+size_t Preferences::putInt(const char *key, int32_t value)
+{
+    if (!values || readOnly)
+        return 0;
+    (*values)[key] = std::to_string(value);
+    return sizeof(value);
+}
+
+size_t Preferences::putString(const char *key, const char *value)
+{
+    if (!values || readOnly)
+        return 0;
+    (*values)[key] = value;
+    return strlen(value);
+}
+
+size_t Preferences::putString(const char *key, String value)
+{
+    return putString(key, value.c_str());
+}
+
+bool Preferences::getBool(const char *key, bool defaultValue)
+{
+    return getUInt(key, defaultValue) != 0;
+}
+
+uint32_t Preferences::getUInt(const char *key, uint32_t defaultValue)
+{
+    if (!isKey(key))
+        return defaultValue;
+    return strtoul((*values)[key].c_str(), nullptr, 10);
+}
+
+int32_t Preferences::getInt(const char *key, int32_t defaultValue)
+{
+    if (!isKey(key))
+        return defaultValue;
+    return strtol((*values)[key].c_str(), nullptr, 10);
+}
+
+String Preferences::getString(const char *key, String defaultValue)
+{
+    if (!isKey(key))
+        return defaultValue;
+    return String((*values)[key].c_str());
+}
@@ -0,0 +1,34 @@
+#ifndef _PREFERENCES_H_
+#define _PREFERENCES_H_
+
+#include "Arduino.h"
+#include <map>
+
+// NVS stand-in that lives for the process only, every run starts from the firmware defaults
+class Preferences
+{
+protected:
+    std::map<std::string, std::string> *values = nullptr;
+    bool readOnly = false;
+
+public:
+    bool begin(const char *name, bool readOnly = false, const char *partition_label = nullptr);
+    void end();
+
+    bool clear();
+    bool remove(const char *key);
+    bool isKey(const char *key);
+
+    size_t putBool(const char *key, bool value);
+    size_t putUInt(const char *key, uint32_t value);
+    size_t putInt(const char *key, int32_t value);
+    size_t putString(const char *key, const char *value);
+    size_t putString(const char *key, String value);
+
+    bool getBool(const char *key, bool defaultValue = false);
+    uint32_t getUInt(const char *key, uint32_t defaultValue = 0);
+    int32_t getInt(const char *key, int32_t defaultValue = 0);
+    String getString(const char *key, String defaultValue = String());
+};
+
+#endif
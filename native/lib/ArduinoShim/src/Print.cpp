@@ -0,0 +1,162 @@
+#include "Print.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        if (!write(*buffer++))
+            break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char buf[64];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0)
+        return 0;
+    if ((size_t)len < sizeof(buf))
+        return write((const uint8_t *)buf, len);
+    char *big = (char *)malloc(len + 1);
+    if (!big)
+        return 0;
+    va_start(args, format);
+    vsnprintf(big, len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t *)big, len);
+    free(big);
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+    return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const String &str)
+{
+    return write(str.c_str(), str.length());
+}
+
+size_t Print::print(const char str[])
+{
+    return write(str);
+}
+
+size_t Print::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(int value, int base)
+{
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(long value, int base)
+{
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(long long value, int base)
+{
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long long value, int base)
+{
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(double value, int digits)
+{
+    return print(String(value, (unsigned int)digits));
+}
+
+size_t Print::println(void)
+{
+    return print("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *str)
+{
+    return print(str) + println();
+}
+
+size_t Print::println(const String &str)
+{
+    return print(str) + println();
+}
+
+size_t Print::println(const char str[])
+{
+    return print(str) + println();
+}
+
+size_t Print::println(char c)
+{
+    return print(c) + println();
+}
+
+size_t Print::println(unsigned char value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(int value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(long long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits)
+{
+    return print(value, digits) + println();
+}
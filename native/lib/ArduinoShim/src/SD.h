@@ -0,0 +1,27 @@
+#ifndef _SD_H_
+#define _SD_H_
+
+#include "FS.h"
+
+namespace fs
+{
+
+// Only here for TJpg_Decoder's SD loader, there is no card and it stays unmounted
+class SDFS : public FS
+{
+public:
+    bool begin()
+    {
+        return false;
+    }
+    void end()
+    {
+        unmount();
+    }
+};
+
+} // namespace fs
+
+extern fs::SDFS SD;
+
+#endif
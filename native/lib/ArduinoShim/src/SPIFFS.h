@@ -0,0 +1,32 @@
+#ifndef _SPIFFS_H_
+#define _SPIFFS_H_
+
+#include "FS.h"
+
+namespace fs
+{
+
+// Only here for TJpg_Decoder's default arguments, it stays unmounted
+class SPIFFSFS : public FS
+{
+public:
+    bool begin(bool formatOnFail = false, const char *basePath = "spiffs", uint8_t maxOpenFiles = 10,
+               const char *partitionLabel = nullptr)
+    {
+        return mounted() || mount(basePath);
+    }
+    bool format()
+    {
+        return false;
+    }
+    void end()
+    {
+        unmount();
+    }
+};
+
+} // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef TICKER_H
+#define TICKER_H
+
+#include <stdint.h>
+
+// Timers never fire on the host, the emulator does not run alarms or the timer app
+class Ticker
+{
+public:
+    typedef void (*callback_t)(void);
+
+    void attach(float seconds, callback_t callback) {}
+    void attach_ms(uint32_t milliseconds, callback_t callback) {}
+    void once(float seconds, callback_t callback) {}
+    void once_ms(uint32_t milliseconds, callback_t callback) {}
+    void detach() {}
+    bool active()
+    {
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,470 @@
+#include "WString.h"
+#include <algorithm>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Same as the core since 2.0, which formats through printf as well
+char *dtostrf(double number, signed int width, unsigned int prec, char *s)
+{
+    sprintf(s, "%*.*f", width, prec, number);
+    return s;
+}
+
+static std::string toBase(unsigned long long value, bool negative, unsigned char base)
+{
+    if (base < 2 || base > 36)
+        base = 10;
+    char buf[72];
+    char *p = buf + sizeof(buf);
+    *--p = '\0';
+    do
+    {
+        unsigned digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value);
+    if (negative)
+        *--p = '-';
+    return p;
+}
+
+static std::string signedToBase(long long value, unsigned char base)
+{
+    // Like ltoa, only decimal numbers carry a sign
+    if (base == 10 && value < 0)
+        return toBase(0ULL - (unsigned long long)value, true, base);
+    return toBase((unsigned long long)value, false, base);
+}
+
+String::String(const char *cstr) : s(cstr ? cstr : "") {}
+
+String::String(const char *cstr, unsigned int length) : s(cstr ? std::string(cstr, length) : std::string()) {}
+
+String::String(const __FlashStringHelper *str) : String(reinterpret_cast<const char *>(str)) {}
+
+String::String(char c) : s(1, c) {}
+
+String::String(unsigned char value, unsigned char base) : s(toBase(value, false, base)) {}
+
+String::String(int value, unsigned char base) : s(signedToBase(value, base)) {}
+
+String::String(unsigned int value, unsigned char base) : s(toBase(value, false, base)) {}
+
+String::String(long value, unsigned char base) : s(signedToBase(value, base)) {}
+
+String::String(unsigned long value, unsigned char base) : s(toBase(value, false, base)) {}
+
+String::String(long long value, unsigned char base) : s(signedToBase(value, base)) {}
+
+String::String(unsigned long long value, unsigned char base) : s(toBase(value, false, base)) {}
+
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned int decimalPlaces)
+{
+    char buf[decimalPlaces + 42];
+    s = dtostrf(value, decimalPlaces + 2, decimalPlaces, buf);
+}
+
+String &String::operator=(const char *cstr)
+{
+    s = cstr ? cstr : "";
+    return *this;
+}
+
+String &String::operator=(const __FlashStringHelper *str)
+{
+    return *this = reinterpret_cast<const char *>(str);
+}
+
+bool String::reserve(unsigned int size)
+{
+    s.reserve(size);
+    return true;
+}
+
+bool String::concat(const String &str)
+{
+    s += str.s;
+    return true;
+}
+
+bool String::concat(const char *cstr)
+{
+    if (!cstr)
+        return false;
+    s += cstr;
+    return true;
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+    if (!cstr)
+        return false;
+    s.append(cstr, length);
+    return true;
+}
+
+bool String::concat(const uint8_t *cstr, unsigned int length)
+{
+    return concat(reinterpret_cast<const char *>(cstr), length);
+}
+
+bool String::concat(char c)
+{
+    s += c;
+    return true;
+}
+
+bool String::concat(unsigned char num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(int num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(unsigned int num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(long num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(unsigned long num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(long long num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(unsigned long long num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(float num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(double num)
+{
+    return concat(String(num));
+}
+
+bool String::concat(const __FlashStringHelper *str)
+{
+    return concat(reinterpret_cast<const char *>(str));
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, const String &rhs)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(rhs);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, const char *cstr)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(cstr);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, char c)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(c);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, unsigned char num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, int num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, unsigned int num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, long num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, long long num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long long num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, float num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, double num)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(num);
+    return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, const __FlashStringHelper *rhs)
+{
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+    a.concat(rhs);
+    return a;
+}
+
+int String::compareTo(const String &str) const
+{
+    return strcmp(c_str(), str.c_str());
+}
+
+bool String::equals(const String &str) const
+{
+    return s == str.s;
+}
+
+bool String::equals(const char *cstr) const
+{
+    return cstr ? s == cstr : s.empty();
+}
+
+bool String::equalsIgnoreCase(const String &str) const
+{
+    return length() == str.length() && strcasecmp(c_str(), str.c_str()) == 0;
+}
+
+bool String::startsWith(const String &prefix) const
+{
+    return prefix.length() <= length() && s.compare(0, prefix.length(), prefix.s) == 0;
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const
+{
+    return offset <= length() && prefix.length() <= length() - offset && s.compare(offset, prefix.length(), prefix.s) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return suffix.length() <= length() && s.compare(length() - suffix.length(), suffix.length(), suffix.s) == 0;
+}
+
+char String::charAt(unsigned int index) const
+{
+    return operator[](index);
+}
+
+void String::setCharAt(unsigned int index, char c)
+{
+    if (index < length())
+        s[index] = c;
+}
+
+char String::operator[](unsigned int index) const
+{
+    return index < length() ? s[index] : 0;
+}
+
+char &String::operator[](unsigned int index)
+{
+    static char dummy;
+    if (index >= length())
+    {
+        dummy = 0;
+        return dummy;
+    }
+    return s[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+    if (!bufsize || !buf)
+        return;
+    if (index >= length())
+    {
+        buf[0] = 0;
+        return;
+    }
+    unsigned int n = std::min(bufsize - 1, length() - index);
+    memcpy(buf, c_str() + index, n);
+    buf[n] = 0;
+}
+
+int String::indexOf(char ch) const
+{
+    return indexOf(ch, 0);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+    if (fromIndex >= length())
+        return -1;
+    size_t found = s.find(ch, fromIndex);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::indexOf(const String &str) const
+{
+    return indexOf(str, 0);
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const
+{
+    if (fromIndex >= length())
+        return -1;
+    size_t found = s.find(str.s, fromIndex);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::lastIndexOf(char ch) const
+{
+    return lastIndexOf(ch, length() - 1);
+}
+
+int String::lastIndexOf(char ch, unsigned int fromIndex) const
+{
+    if (fromIndex >= length())
+        return -1;
+    size_t found = s.rfind(ch, fromIndex);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+    return lastIndexOf(str, length() - str.length());
+}
+
+int String::lastIndexOf(const String &str, unsigned int fromIndex) const
+{
+    if (str.length() == 0 || str.length() > length() || fromIndex >= length())
+        return -1;
+    size_t found = s.rfind(str.s, fromIndex);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+String String::substring(unsigned int left, unsigned int right) const
+{
+    if (left > right)
+        std::swap(left, right);
+    if (left >= length())
+        return String();
+    if (right > length())
+        right = length();
+    return String(c_str() + left, right - left);
+}
+
+void String::replace(char find, char replace)
+{
+    for (char &c : s)
+        if (c == find)
+            c = replace;
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    if (find.length() == 0)
+        return;
+    size_t pos = 0;
+    while ((pos = s.find(find.s, pos)) != std::string::npos)
+    {
+        s.replace(pos, find.length(), replace.s);
+        pos += replace.length();
+    }
+}
+
+void String::remove(unsigned int index)
+{
+    remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index >= length() || count == 0)
+        return;
+    if (count > length() - index)
+        count = length() - index;
+    s.erase(index, count);
+}
+
+void String::toLowerCase()
+{
+    for (char &c : s)
+        c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase()
+{
+    for (char &c : s)
+        c = toupper((unsigned char)c);
+}
+
+void String::trim()
+{
+    size_t begin = 0, end = s.length();
+    while (begin < end && isspace((unsigned char)s[begin]))
+        begin++;
+    while (end > begin && isspace((unsigned char)s[end - 1]))
+        end--;
+    s = s.substr(begin, end - begin);
+}
+
+long String::toInt() const
+{
+    return atol(c_str());
+}
+
+float String::toFloat() const
+{
+    return atof(c_str());
+}
+
+double String::toDouble() const
+{
+    return atof(c_str());
+}
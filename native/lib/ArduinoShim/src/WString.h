@@ -0,0 +1,216 @@
+#ifndef String_class_h
+#define String_class_h
+
+// The Arduino String, kept on top of std::string. Conversions and edge cases
+// (substring bounds, number formatting) behave like the ESP32 core.
+
+#include <stdint.h>
+#include <string>
+
+class __FlashStringHelper;
+#define FPSTR(pstr_pointer) (reinterpret_cast<const __FlashStringHelper *>(pstr_pointer))
+#define F(string_literal) (FPSTR(PSTR(string_literal)))
+
+class StringSumHelper;
+
+char *dtostrf(double number, signed int width, unsigned int prec, char *s);
+
+class String
+{
+public:
+    String(const char *cstr = "");
+    String(const char *cstr, unsigned int length);
+    String(const String &str) = default;
+    String(String &&str) = default;
+    String(const __FlashStringHelper *str);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    String &operator=(const String &rhs) = default;
+    String &operator=(String &&rhs) = default;
+    String &operator=(const char *cstr);
+    String &operator=(const __FlashStringHelper *str);
+
+    bool reserve(unsigned int size);
+    inline unsigned int length() const
+    {
+        return s.length();
+    }
+    inline bool isEmpty() const
+    {
+        return s.empty();
+    }
+
+    bool concat(const String &str);
+    bool concat(const char *cstr);
+    bool concat(const char *cstr, unsigned int length);
+    bool concat(const uint8_t *cstr, unsigned int length);
+    bool concat(char c);
+    bool concat(unsigned char num);
+    bool concat(int num);
+    bool concat(unsigned int num);
+    bool concat(long num);
+    bool concat(unsigned long num);
+    bool concat(long long num);
+    bool concat(unsigned long long num);
+    bool concat(float num);
+    bool concat(double num);
+    bool concat(const __FlashStringHelper *str);
+
+    template <typename T>
+    String &operator+=(const T &rhs)
+    {
+        concat(rhs);
+        return *this;
+    }
+
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, const String &rhs);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, const char *cstr);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, char c);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned char num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, int num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned int num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, long num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, long long num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long long num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, float num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, double num);
+    friend StringSumHelper &operator+(const StringSumHelper &lhs, const __FlashStringHelper *rhs);
+
+    int compareTo(const String &str) const;
+    bool equals(const String &str) const;
+    bool equals(const char *cstr) const;
+    bool equalsIgnoreCase(const String &str) const;
+    bool operator==(const String &rhs) const
+    {
+        return equals(rhs);
+    }
+    bool operator==(const char *cstr) const
+    {
+        return equals(cstr);
+    }
+    bool operator!=(const String &rhs) const
+    {
+        return !equals(rhs);
+    }
+    bool operator!=(const char *cstr) const
+    {
+        return !equals(cstr);
+    }
+    bool operator<(const String &rhs) const
+    {
+        return compareTo(rhs) < 0;
+    }
+    bool operator>(const String &rhs) const
+    {
+        return compareTo(rhs) > 0;
+    }
+    bool operator<=(const String &rhs) const
+    {
+        return compareTo(rhs) <= 0;
+    }
+    bool operator>=(const String &rhs) const
+    {
+        return compareTo(rhs) >= 0;
+    }
+    bool startsWith(const String &prefix) const;
+    bool startsWith(const String &prefix, unsigned int offset) const;
+    bool endsWith(const String &suffix) const;
+
+    char charAt(unsigned int index) const;
+    void setCharAt(unsigned int index, char c);
+    char operator[](unsigned int index) const;
+    char &operator[](unsigned int index);
+    void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const
+    {
+        getBytes((unsigned char *)buf, bufsize, index);
+    }
+    inline const char *c_str() const
+    {
+        return s.c_str();
+    }
+    char *begin()
+    {
+        return &s[0];
+    }
+    char *end()
+    {
+        return &s[0] + s.length();
+    }
+    const char *begin() const
+    {
+        return c_str();
+    }
+    const char *end() const
+    {
+        return c_str() + length();
+    }
+
+    int indexOf(char ch) const;
+    int indexOf(char ch, unsigned int fromIndex) const;
+    int indexOf(const String &str) const;
+    int indexOf(const String &str, unsigned int fromIndex) const;
+    int lastIndexOf(char ch) const;
+    int lastIndexOf(char ch, unsigned int fromIndex) const;
+    int lastIndexOf(const String &str) const;
+    int lastIndexOf(const String &str, unsigned int fromIndex) const;
+    String substring(unsigned int beginIndex) const
+    {
+        return substring(beginIndex, length());
+    }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void replace(char find, char replace);
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+private:
+    std::string s;
+};
+
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const String &s) : String(s) {}
+    StringSumHelper(const char *p) : String(p) {}
+    StringSumHelper(char c) : String(c) {}
+    StringSumHelper(unsigned char num) : String(num) {}
+    StringSumHelper(int num) : String(num) {}
+    StringSumHelper(unsigned int num) : String(num) {}
+    StringSumHelper(long num) : String(num) {}
+    StringSumHelper(unsigned long num) : String(num) {}
+    StringSumHelper(long long num) : String(num) {}
+    StringSumHelper(unsigned long long num) : String(num) {}
+    StringSumHelper(float num) : String(num) {}
+    StringSumHelper(double num) : String(num) {}
+};
+
+inline bool operator==(const char *lhs, const String &rhs)
+{
+    return rhs == lhs;
+}
+
+inline bool operator!=(const char *lhs, const String &rhs)
+{
+    return rhs != lhs;
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef WiFi_h
+#define WiFi_h
+
+#include "Arduino.h"
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+// The host is never on a network, the station reports itself disconnected
+class WiFiClass
+{
+public:
+    uint8_t *macAddress(uint8_t *mac)
+    {
+        static const uint8_t hostMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+        memcpy(mac, hostMac, sizeof(hostMac));
+        return mac;
+    }
+    String macAddress()
+    {
+        return String("02:00:00:00:00:01");
+    }
+    int8_t RSSI()
+    {
+        return 0;
+    }
+    uint8_t status()
+    {
+        return WL_DISCONNECTED;
+    }
+    bool isConnected()
+    {
+        return false;
+    }
+    IPAddress localIP()
+    {
+        return IPAddress();
+    }
+};
+
+extern WiFiClass WiFi;
+
+#endif
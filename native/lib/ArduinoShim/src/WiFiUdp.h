@@ -0,0 +1,66 @@
+#ifndef _WIFIUDP_H_
+#define _WIFIUDP_H_
+
+#include "Arduino.h"
+
+// Nothing arrives and nothing is sent, Art-Net stays idle on the host
+class WiFiUDP : public Stream
+{
+public:
+    uint8_t begin(uint16_t port)
+    {
+        return 1;
+    }
+    void stop() {}
+    int beginPacket(IPAddress ip, uint16_t port)
+    {
+        return 1;
+    }
+    int beginPacket(const char *host, uint16_t port)
+    {
+        return 1;
+    }
+    int endPacket()
+    {
+        return 1;
+    }
+    size_t write(uint8_t) override
+    {
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        return size;
+    }
+    using Print::write;
+    int parsePacket()
+    {
+        return 0;
+    }
+    int available() override
+    {
+        return 0;
+    }
+    int read() override
+    {
+        return -1;
+    }
+    int read(unsigned char *buffer, size_t len)
+    {
+        return 0;
+    }
+    int peek() override
+    {
+        return -1;
+    }
+    IPAddress remoteIP()
+    {
+        return IPAddress();
+    }
+    uint16_t remotePort()
+    {
+        return 0;
+    }
+};
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+#include <stdint.h>
+
+// µs since start, from the same clock as millis() and micros()
+int64_t esp_timer_get_time();
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef _ADAFRUIT_GFX_H
+#define _ADAFRUIT_GFX_H
+
+// Host stand-in for the Adafruit_GFX primitives the firmware draws with. Lines, rectangles,
+// circles and GFXfont text rasterize like the library. The built-in 5x7 font isn't
+// included, text needs a GFXfont, which the firmware always sets.
+
+#include <Arduino.h>
+#include "gfxfont.h"
+
+class Adafruit_GFX : public Print
+{
+public:
+    Adafruit_GFX(int16_t w, int16_t h);
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    virtual void startWrite(void) {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color)
+    {
+        drawPixel(x, y, color);
+    }
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+        fillRect(x, y, w, h, color);
+    }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+        drawFastVLine(x, y, h, color);
+    }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+        drawFastHLine(x, y, w, color);
+    }
+    virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    virtual void endWrite(void) {}
+
+    virtual void setRotation(uint8_t r);
+    virtual void invertDisplay(bool i) {}
+
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void fillScreen(uint16_t color);
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, int16_t delta, uint16_t color);
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+    {
+        drawChar(x, y, c, color, bg, size, size);
+    }
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+    void setTextSize(uint8_t s)
+    {
+        setTextSize(s, s);
+    }
+    void setTextSize(uint8_t sx, uint8_t sy)
+    {
+        textsize_x = (sx > 0) ? sx : 1;
+        textsize_y = (sy > 0) ? sy : 1;
+    }
+    void setFont(const GFXfont *f = NULL);
+
+    void setCursor(int16_t x, int16_t y)
+    {
+        cursor_x = x;
+        cursor_y = y;
+    }
+    void setTextColor(uint16_t c)
+    {
+        textcolor = textbgcolor = c;
+    }
+    void setTextColor(uint16_t c, uint16_t bg)
+    {
+        textcolor = c;
+        textbgcolor = bg;
+    }
+    void setTextWrap(bool w)
+    {
+        wrap = w;
+    }
+    void cp437(bool x = true)
+    {
+        _cp437 = x;
+    }
+
+    using Print::write;
+    virtual size_t write(uint8_t) override;
+
+    int16_t width(void) const
+    {
+        return _width;
+    };
+    int16_t height(void) const
+    {
+        return _height;
+    }
+    uint8_t getRotation(void) const
+    {
+        return rotation;
+    }
+    int16_t getCursorX(void) const
+    {
+        return cursor_x;
+    }
+    int16_t getCursorY(void) const
+    {
+        return cursor_y;
+    };
+
+protected:
+    int16_t WIDTH;
+    int16_t HEIGHT;
+    int16_t _width;
+    int16_t _height;
+    int16_t cursor_x;
+    int16_t cursor_y;
+    uint16_t textcolor;
+    uint16_t textbgcolor;
+    uint8_t textsize_x;
+    uint8_t textsize_y;
+    uint8_t rotation;
+    bool wrap;
+    bool _cp437;
+    GFXfont *gfxFont;
+};
+
+// 1 bit offscreen canvas, rows are packed MSB first
+class GFXcanvas1 : public Adafruit_GFX
+{
+public:
+    GFXcanvas1(uint16_t w, uint16_t h);
+    ~GFXcanvas1(void);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    bool getPixel(int16_t x, int16_t y) const;
+    uint8_t *getBuffer(void) const
+    {
+        return buffer;
+    }
+
+private:
+    uint8_t *buffer;
+};
+
+#endif
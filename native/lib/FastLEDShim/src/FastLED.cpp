@@ -0,0 +1,431 @@
+#include "FastLED.h"
+
+CFastLED FastLED;
+uint16_t rand16seed = 1337;
+
+int16_t sin16(uint16_t theta)
+{
+    static const uint16_t base[] = {0, 6393, 12539, 18204, 23170, 27245, 30273, 32137};
+    static const uint8_t slope[] = {49, 48, 44, 38, 31, 23, 14, 4};
+
+    uint16_t offset = (theta & 0x3FFF) >> 3; // 0..2047
+    if (theta & 0x4000)
+        offset = 2047 - offset;
+
+    uint8_t section = offset / 256; // 0..7
+    uint16_t b = base[section];
+    uint8_t m = slope[section];
+    uint8_t secoffset8 = (uint8_t)(offset) / 2;
+    uint16_t mx = m * secoffset8;
+    int16_t y = mx + b;
+    if (theta & 0x8000)
+        y = -y;
+    return y;
+}
+
+uint8_t sin8(uint8_t theta)
+{
+    static const uint8_t b_m16_interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+
+    uint8_t offset = theta;
+    if (theta & 0x40)
+        offset = (uint8_t)255 - offset;
+    offset &= 0x3F; // 0..63
+
+    uint8_t secoffset = offset & 0x0F; // 0..15
+    if (theta & 0x40)
+        ++secoffset;
+
+    uint8_t section = offset >> 4; // 0..3
+    const uint8_t *p = b_m16_interleave + section * 2;
+    uint8_t b = p[0];
+    uint8_t m16 = p[1];
+    uint8_t mx = (m16 * secoffset) >> 4;
+    int8_t y = mx + b;
+    if (theta & 0x80)
+        y = -y;
+    y += 128;
+    return y;
+}
+
+// Ken Perlin's permutation, with the first entry repeated so p[255 + 1] stays in range
+static const uint8_t p[] = {
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+    140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+    247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+    57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+    60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+    65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+    200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+    52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+    207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+    119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+    129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+    81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+    184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+    222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+    151};
+
+#define P(x) p[(uint8_t)(x)]
+
+static int8_t grad8(uint8_t hash, int8_t x, int8_t y, int8_t z)
+{
+    hash &= 0xF;
+    int8_t u = (hash & 8) ? y : x;
+    int8_t v = hash < 4 ? y : hash == 12 || hash == 14 ? x : z;
+    if (hash & 1)
+        u = -u;
+    if (hash & 2)
+        v = -v;
+    return avg7(u, v);
+}
+
+static int8_t grad8(uint8_t hash, int8_t x, int8_t y)
+{
+    hash = hash & 3;
+    int8_t u, v;
+    if (hash & 2)
+    {
+        u = y;
+        v = x;
+    }
+    else
+    {
+        u = x;
+        v = y;
+    }
+    if (hash & 1)
+        u = -u;
+    return avg7(u, v);
+}
+
+static int8_t inoise8_raw(uint16_t x, uint16_t y, uint16_t z)
+{
+    // Find the unit cube containing the point
+    uint8_t X = x >> 8;
+    uint8_t Y = y >> 8;
+    uint8_t Z = z >> 8;
+
+    // Hash cube corner coordinates
+    uint8_t A = P(X) + Y;
+    uint8_t AA = P(A) + Z;
+    uint8_t AB = P(A + 1) + Z;
+    uint8_t B = P(X + 1) + Y;
+    uint8_t BA = P(B) + Z;
+    uint8_t BB = P(B + 1) + Z;
+
+    // Relative position of the point in the cube, eased, and signed for grad8
+    uint8_t u = ease8InOutQuad(x);
+    uint8_t v = ease8InOutQuad(y);
+    uint8_t w = ease8InOutQuad(z);
+    int8_t xx = ((uint8_t)(x) >> 1) & 0x7F;
+    int8_t yy = ((uint8_t)(y) >> 1) & 0x7F;
+    int8_t zz = ((uint8_t)(z) >> 1) & 0x7F;
+    uint8_t N = 0x80;
+
+    int8_t X1 = lerp7by8(grad8(P(AA), xx, yy, zz), grad8(P(BA), xx - N, yy, zz), u);
+    int8_t X2 = lerp7by8(grad8(P(AB), xx, yy - N, zz), grad8(P(BB), xx - N, yy - N, zz), u);
+    int8_t X3 = lerp7by8(grad8(P(AA + 1), xx, yy, zz - N), grad8(P(BA + 1), xx - N, yy, zz - N), u);
+    int8_t X4 = lerp7by8(grad8(P(AB + 1), xx, yy - N, zz - N), grad8(P(BB + 1), xx - N, yy - N, zz - N), u);
+
+    int8_t Y1 = lerp7by8(X1, X2, v);
+    int8_t Y2 = lerp7by8(X3, X4, v);
+    return lerp7by8(Y1, Y2, w);
+}
+
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z)
+{
+    int8_t n = inoise8_raw(x, y, z); // -64..+64
+    n += 64;                         //   0..128
+    return qadd8(n, n);              //   0..255
+}
+
+static int8_t inoise8_raw(uint16_t x, uint16_t y)
+{
+    uint8_t X = x >> 8;
+    uint8_t Y = y >> 8;
+
+    uint8_t A = P(X) + Y;
+    uint8_t AA = P(A);
+    uint8_t AB = P(A + 1);
+    uint8_t B = P(X + 1) + Y;
+    uint8_t BA = P(B);
+    uint8_t BB = P(B + 1);
+
+    uint8_t u = ease8InOutQuad(x);
+    uint8_t v = ease8InOutQuad(y);
+    int8_t xx = ((uint8_t)(x) >> 1) & 0x7F;
+    int8_t yy = ((uint8_t)(y) >> 1) & 0x7F;
+    uint8_t N = 0x80;
+
+    int8_t X1 = lerp7by8(grad8(P(AA), xx, yy), grad8(P(BA), xx - N, yy), u);
+    int8_t X2 = lerp7by8(grad8(P(AB), xx, yy - N), grad8(P(BB), xx - N, yy - N), u);
+    return lerp7by8(X1, X2, v);
+}
+
+uint8_t inoise8(uint16_t x, uint16_t y)
+{
+    int8_t n = inoise8_raw(x, y);
+    n += 64;
+    return qadd8(n, n);
+}
+
+uint8_t applyGamma_video(uint8_t brightness, float gamma)
+{
+    float orig = (float)(brightness) / (255.0);
+    float adj = pow(orig, gamma) * (255.0);
+    uint8_t result = (uint8_t)(adj);
+    if ((brightness > 0) && (result == 0))
+        result = 1; // never gamma-adjust a positive number down to zero
+    return result;
+}
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb)
+{
+    const uint8_t K255 = 255;
+    const uint8_t K171 = 171;
+    const uint8_t K170 = 170;
+    const uint8_t K85 = 85;
+
+    uint8_t hue = hsv.hue;
+    uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset = hue & 0x1F; // 0..31
+    uint8_t offset8 = offset << 3;
+    uint8_t third = scale8(offset8, (256 / 3)); // max = 85
+
+    uint8_t r, g, b;
+    if (!(hue & 0x80))
+    {
+        if (!(hue & 0x40))
+        {
+            if (!(hue & 0x20))
+            {
+                // R -> O
+                r = K255 - third;
+                g = third;
+                b = 0;
+            }
+            else
+            {
+                // O -> Y
+                r = K171;
+                g = K85 + third;
+                b = 0;
+            }
+        }
+        else
+        {
+            if (!(hue & 0x20))
+            {
+                // Y -> G
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); // max = 170
+                r = K171 - twothirds;
+                g = K170 + third;
+                b = 0;
+            }
+            else
+            {
+                // G -> A
+                r = 0;
+                g = K255 - third;
+                b = third;
+            }
+        }
+    }
+    else
+    {
+        if (!(hue & 0x40))
+        {
+            if (!(hue & 0x20))
+            {
+                // A -> B
+                r = 0;
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); // max = 170
+                g = K171 - twothirds;
+                b = K85 + twothirds;
+            }
+            else
+            {
+                // B -> P
+                r = third;
+                g = 0;
+                b = K255 - third;
+            }
+        }
+        else
+        {
+            if (!(hue & 0x20))
+            {
+                // P -> K
+                r = K85 + third;
+                g = 0;
+                b = K171 - third;
+            }
+            else
+            {
+                // K -> R
+                r = K170 + third;
+                g = 0;
+                b = K85 - third;
+            }
+        }
+    }
+
+    // Scale down colors if desaturated and add the brightness floor
+    if (sat != 255)
+    {
+        if (sat == 0)
+        {
+            r = 255;
+            b = 255;
+            g = 255;
+        }
+        else
+        {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            if (r)
+                r = scale8(r, satscale);
+            if (g)
+                g = scale8(g, satscale);
+            if (b)
+                b = scale8(b, satscale);
+            uint8_t brightness_floor = desat;
+            r += brightness_floor;
+            g += brightness_floor;
+            b += brightness_floor;
+        }
+    }
+
+    // Scale everything down if value < 255
+    if (val != 255)
+    {
+        val = scale8_video(val, val);
+        if (val == 0)
+        {
+            r = 0;
+            g = 0;
+            b = 0;
+        }
+        else
+        {
+            if (r)
+                r = scale8(r, val);
+            if (g)
+                g = scale8(g, val);
+            if (b)
+                b = scale8(b, val);
+        }
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
+
+void hsv2rgb_raw(const CHSV &hsv, CRGB &rgb)
+{
+    const uint8_t HSV_SECTION_3 = 0x40;
+
+    uint8_t value = hsv.val;
+    uint8_t saturation = hsv.sat;
+    uint8_t invsat = 255 - saturation;
+    uint8_t brightness_floor = (value * invsat) / 256;
+    uint8_t color_amplitude = value - brightness_floor;
+
+    uint8_t section = hsv.hue / HSV_SECTION_3; // 0..2
+    uint8_t offset = hsv.hue % HSV_SECTION_3;  // 0..63
+    uint8_t rampup = offset;
+    uint8_t rampdown = (HSV_SECTION_3 - 1) - offset;
+    uint8_t rampup_amp_adj = (rampup * color_amplitude) / (256 / 4);
+    uint8_t rampdown_amp_adj = (rampdown * color_amplitude) / (256 / 4);
+    uint8_t rampup_adj_with_floor = rampup_amp_adj + brightness_floor;
+    uint8_t rampdown_adj_with_floor = rampdown_amp_adj + brightness_floor;
+
+    if (section)
+    {
+        if (section == 1)
+        {
+            rgb.r = brightness_floor;
+            rgb.g = rampdown_adj_with_floor;
+            rgb.b = rampup_adj_with_floor;
+        }
+        else
+        {
+            rgb.r = rampup_adj_with_floor;
+            rgb.g = brightness_floor;
+            rgb.b = rampdown_adj_with_floor;
+        }
+    }
+    else
+    {
+        rgb.r = rampdown_adj_with_floor;
+        rgb.g = rampup_adj_with_floor;
+        rgb.b = brightness_floor;
+    }
+}
+
+void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb)
+{
+    CHSV hsv2(hsv);
+    hsv2.hue = scale8(hsv2.hue, 191);
+    hsv2rgb_raw(hsv2, rgb);
+}
+
+const TProgmemRGBPalette16 RainbowColors_p = {
+    0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00,
+    0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+    0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5,
+    0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B};
+
+const TProgmemRGBPalette16 OceanColors_p = {
+    CRGB::MidnightBlue, CRGB::DarkBlue, CRGB::MidnightBlue, CRGB::Navy,
+    CRGB::DarkBlue, CRGB::MediumBlue, CRGB::SeaGreen, CRGB::Teal,
+    CRGB::CadetBlue, CRGB::Blue, CRGB::DarkCyan, CRGB::CornflowerBlue,
+    CRGB::Aquamarine, CRGB::SeaGreen, CRGB::Aqua, CRGB::LightSkyBlue};
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness, TBlendType blendType)
+{
+    uint8_t hi4 = index >> 4;
+    uint8_t lo4 = index & 0x0F;
+
+    const CRGB *entry = &(pal[0]) + hi4;
+    uint8_t red1 = entry->red;
+    uint8_t green1 = entry->green;
+    uint8_t blue1 = entry->blue;
+
+    if (lo4 && (blendType != NOBLEND))
+    {
+        entry = hi4 == 15 ? &(pal[0]) : entry + 1;
+        uint8_t f2 = lo4 << 4;
+        uint8_t f1 = 255 - f2;
+        red1 = scale8(red1, f1) + scale8(entry->red, f2);
+        green1 = scale8(green1, f1) + scale8(entry->green, f2);
+        blue1 = scale8(blue1, f1) + scale8(entry->blue, f2);
+    }
+
+    if (brightness != 255)
+    {
+        if (brightness)
+        {
+            ++brightness; // adjust for rounding
+            if (red1)
+                red1 = scale8(red1, brightness);
+            if (green1)
+                green1 = scale8(green1, brightness);
+            if (blue1)
+                blue1 = scale8(blue1, brightness);
+        }
+        else
+        {
+            red1 = green1 = blue1 = 0;
+        }
+    }
+
+    return CRGB(red1, green1, blue1);
+}
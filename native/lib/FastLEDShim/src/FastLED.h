@@ -0,0 +1,497 @@
+#ifndef __INC_FASTSPI_LED2_H
+#define __INC_FASTSPI_LED2_H
+
+// Host stand-in for the parts of FastLED the firmware uses. The 8 bit math, color
+// conversions, palettes and noise follow the C versions of FastLED 3.5 (scale8 and
+// blend8 in their fixed variants), so effects compute the same colors as on the device.
+// Nothing is sent anywhere, show() only counts the frames it was asked to output.
+
+#include <Arduino.h>
+#include <atomic>
+
+typedef uint8_t fract8;
+typedef uint16_t fract16;
+typedef uint16_t accum88;
+
+inline uint8_t scale8(uint8_t i, fract8 scale)
+{
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale)
+{
+    return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+inline uint16_t scale16(uint16_t i, fract16 scale)
+{
+    return ((uint32_t)i * (1 + (uint32_t)scale)) >> 16;
+}
+
+inline void nscale8x3(uint8_t &r, uint8_t &g, uint8_t &b, fract8 scale)
+{
+    uint16_t scale_fixed = scale + 1;
+    r = (((uint16_t)r) * scale_fixed) >> 8;
+    g = (((uint16_t)g) * scale_fixed) >> 8;
+    b = (((uint16_t)b) * scale_fixed) >> 8;
+}
+
+inline void nscale8x3_video(uint8_t &r, uint8_t &g, uint8_t &b, fract8 scale)
+{
+    uint8_t nonzeroscale = (scale != 0) ? 1 : 0;
+    r = (r == 0) ? 0 : (((int)r * (int)(scale)) >> 8) + nonzeroscale;
+    g = (g == 0) ? 0 : (((int)g * (int)(scale)) >> 8) + nonzeroscale;
+    b = (b == 0) ? 0 : (((int)b * (int)(scale)) >> 8) + nonzeroscale;
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j)
+{
+    unsigned int t = i + j;
+    return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j)
+{
+    int t = i - j;
+    return t < 0 ? 0 : t;
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB)
+{
+    uint16_t partial = (a << 8) | b;
+    partial -= (a * amountOfB);
+    partial += (b * amountOfB);
+    return partial >> 8;
+}
+
+inline int8_t avg7(int8_t i, int8_t j)
+{
+    return (i >> 1) + (j >> 1) + (i & 0x1);
+}
+
+inline int8_t lerp7by8(int8_t a, int8_t b, fract8 frac)
+{
+    if (b > a)
+        return a + scale8(b - a, frac);
+    return a - scale8(a - b, frac);
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i)
+{
+    uint8_t j = i;
+    if (j & 0x80)
+        j = 255 - j;
+    uint8_t jj2 = scale8(j, j) << 1;
+    if (i & 0x80)
+        jj2 = 255 - jj2;
+    return jj2;
+}
+
+int16_t sin16(uint16_t theta);
+uint8_t sin8(uint8_t theta);
+
+inline int16_t cos16(uint16_t theta)
+{
+    return sin16(theta + 16384);
+}
+
+inline uint8_t cos8(uint8_t theta)
+{
+    return sin8(theta + 64);
+}
+
+extern uint16_t rand16seed;
+
+inline uint16_t random16()
+{
+    rand16seed = (rand16seed * 2053) + 13849;
+    return rand16seed;
+}
+
+inline uint16_t random16(uint16_t lim)
+{
+    return ((uint32_t)random16() * lim) >> 16;
+}
+
+inline uint16_t random16(uint16_t min, uint16_t lim)
+{
+    return random16(lim - min) + min;
+}
+
+inline uint8_t random8()
+{
+    rand16seed = (rand16seed * 2053) + 13849;
+    return (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8)));
+}
+
+inline uint8_t random8(uint8_t lim)
+{
+    return (random8() * lim) >> 8;
+}
+
+inline uint8_t random8(uint8_t min, uint8_t lim)
+{
+    return random8(lim - min) + min;
+}
+
+inline void random16_set_seed(uint16_t seed)
+{
+    rand16seed = seed;
+}
+
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z);
+uint8_t inoise8(uint16_t x, uint16_t y);
+
+uint8_t applyGamma_video(uint8_t brightness, float gamma);
+
+struct CRGB;
+
+struct CHSV
+{
+    union
+    {
+        struct
+        {
+            union
+            {
+                uint8_t hue;
+                uint8_t h;
+            };
+            union
+            {
+                uint8_t saturation;
+                uint8_t sat;
+                uint8_t s;
+            };
+            union
+            {
+                uint8_t value;
+                uint8_t val;
+                uint8_t v;
+            };
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() {}
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb);
+void hsv2rgb_raw(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB
+{
+    union
+    {
+        struct
+        {
+            union
+            {
+                uint8_t r;
+                uint8_t red;
+            };
+            union
+            {
+                uint8_t g;
+                uint8_t green;
+            };
+            union
+            {
+                uint8_t b;
+                uint8_t blue;
+            };
+        };
+        uint8_t raw[3];
+    };
+
+    typedef enum : uint32_t
+    {
+        Aqua = 0x00FFFF,
+        Aquamarine = 0x7FFFD4,
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        CadetBlue = 0x5F9EA0,
+        CornflowerBlue = 0x6495ED,
+        Cyan = 0x00FFFF,
+        DarkBlue = 0x00008B,
+        DarkCyan = 0x008B8B,
+        Fuchsia = 0xFF00FF,
+        Gray = 0x808080,
+        Green = 0x008000,
+        LightSkyBlue = 0x87CEFA,
+        Lime = 0x00FF00,
+        Magenta = 0xFF00FF,
+        MediumBlue = 0x0000CD,
+        MidnightBlue = 0x191970,
+        Navy = 0x000080,
+        Orange = 0xFFA500,
+        Pink = 0xFFC0CB,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        SeaGreen = 0x2E8B57,
+        Teal = 0x008080,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00
+    } HTMLColorCode;
+
+    inline uint8_t &operator[](uint8_t x)
+    {
+        return raw[x];
+    }
+    inline const uint8_t &operator[](uint8_t x) const
+    {
+        return raw[x];
+    }
+
+    CRGB() {}
+    constexpr CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    constexpr CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b((colorcode >> 0) & 0xFF) {}
+    constexpr CRGB(HTMLColorCode colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b((colorcode >> 0) & 0xFF) {}
+    CRGB(const CHSV &rhs)
+    {
+        hsv2rgb_rainbow(rhs, *this);
+    }
+    CRGB(const CRGB &rhs) = default;
+    CRGB &operator=(const CRGB &rhs) = default;
+
+    inline CRGB &operator=(const CHSV &rhs)
+    {
+        hsv2rgb_rainbow(rhs, *this);
+        return *this;
+    }
+    inline CRGB &operator=(const uint32_t colorcode)
+    {
+        r = (colorcode >> 16) & 0xFF;
+        g = (colorcode >> 8) & 0xFF;
+        b = (colorcode >> 0) & 0xFF;
+        return *this;
+    }
+    inline CRGB &setRGB(uint8_t nr, uint8_t ng, uint8_t nb)
+    {
+        r = nr;
+        g = ng;
+        b = nb;
+        return *this;
+    }
+    inline CRGB &setHSV(uint8_t hue, uint8_t sat, uint8_t val)
+    {
+        hsv2rgb_rainbow(CHSV(hue, sat, val), *this);
+        return *this;
+    }
+    inline CRGB &setHue(uint8_t hue)
+    {
+        return setHSV(hue, 255, 255);
+    }
+    inline CRGB &operator+=(const CRGB &rhs)
+    {
+        r = qadd8(r, rhs.r);
+        g = qadd8(g, rhs.g);
+        b = qadd8(b, rhs.b);
+        return *this;
+    }
+    inline CRGB &operator-=(const CRGB &rhs)
+    {
+        r = qsub8(r, rhs.r);
+        g = qsub8(g, rhs.g);
+        b = qsub8(b, rhs.b);
+        return *this;
+    }
+    inline CRGB &nscale8_video(uint8_t scaledown)
+    {
+        nscale8x3_video(r, g, b, scaledown);
+        return *this;
+    }
+    inline CRGB &operator%=(uint8_t scaledown)
+    {
+        return nscale8_video(scaledown);
+    }
+    inline CRGB &fadeLightBy(uint8_t fadefactor)
+    {
+        return nscale8_video(255 - fadefactor);
+    }
+    inline CRGB &nscale8(uint8_t scaledown)
+    {
+        nscale8x3(r, g, b, scaledown);
+        return *this;
+    }
+    inline CRGB &nscale8(const CRGB &scaledown)
+    {
+        r = scale8(r, scaledown.r);
+        g = scale8(g, scaledown.g);
+        b = scale8(b, scaledown.b);
+        return *this;
+    }
+    inline CRGB &fadeToBlackBy(uint8_t fadefactor)
+    {
+        nscale8x3(r, g, b, 255 - fadefactor);
+        return *this;
+    }
+    inline explicit operator uint32_t() const
+    {
+        return uint32_t{0xff000000} | (uint32_t{r} << 16) | (uint32_t{g} << 8) | uint32_t{b};
+    }
+    inline operator bool() const
+    {
+        return r || g || b;
+    }
+    inline uint8_t getLuma() const
+    {
+        return scale8(r, 54) + scale8(g, 183) + scale8(b, 18);
+    }
+    inline uint8_t getAverageLight() const
+    {
+        return scale8(r, 85) + scale8(g, 85) + scale8(b, 85);
+    }
+};
+
+inline bool operator==(const CRGB &lhs, const CRGB &rhs)
+{
+    return (lhs.r == rhs.r) && (lhs.g == rhs.g) && (lhs.b == rhs.b);
+}
+
+inline bool operator!=(const CRGB &lhs, const CRGB &rhs)
+{
+    return !(lhs == rhs);
+}
+
+inline CRGB operator+(const CRGB &p1, const CRGB &p2)
+{
+    return CRGB(qadd8(p1.r, p2.r), qadd8(p1.g, p2.g), qadd8(p1.b, p2.b));
+}
+
+inline CRGB operator-(const CRGB &p1, const CRGB &p2)
+{
+    return CRGB(qsub8(p1.r, p2.r), qsub8(p1.g, p2.g), qsub8(p1.b, p2.b));
+}
+
+inline CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2)
+{
+    return CRGB(blend8(p1.r, p2.r, amountOfP2), blend8(p1.g, p2.g, amountOfP2), blend8(p1.b, p2.b, amountOfP2));
+}
+
+inline void fill_solid(CRGB *leds, int numToFill, const CRGB &color)
+{
+    for (int i = 0; i < numToFill; ++i)
+        leds[i] = color;
+}
+
+inline void fadeToBlackBy(CRGB *leds, uint16_t num_leds, uint8_t fadeBy)
+{
+    for (uint16_t i = 0; i < num_leds; ++i)
+        leds[i].fadeToBlackBy(fadeBy);
+}
+
+typedef uint32_t TProgmemRGBPalette16[16];
+
+enum TBlendType
+{
+    NOBLEND = 0,
+    LINEARBLEND = 1
+};
+
+class CRGBPalette16
+{
+public:
+    CRGB entries[16];
+
+    CRGBPalette16() {}
+    CRGBPalette16(const TProgmemRGBPalette16 &rhs)
+    {
+        for (uint8_t i = 0; i < 16; ++i)
+            entries[i] = rhs[i];
+    }
+    inline CRGB &operator[](uint8_t x)
+    {
+        return entries[x];
+    }
+    inline const CRGB &operator[](uint8_t x) const
+    {
+        return entries[x];
+    }
+};
+
+extern const TProgmemRGBPalette16 RainbowColors_p;
+extern const TProgmemRGBPalette16 OceanColors_p;
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND);
+
+class CLEDController
+{
+    CRGB *m_Data = nullptr;
+    int m_nLeds = 0;
+
+public:
+    CLEDController &setLeds(CRGB *data, int nLeds)
+    {
+        m_Data = data;
+        m_nLeds = nLeds;
+        return *this;
+    }
+    CRGB *leds()
+    {
+        return m_Data;
+    }
+    int size()
+    {
+        return m_nLeds;
+    }
+};
+
+// Only the chipset name is used, the data pin doesn't matter on the host
+template <uint8_t DATA_PIN>
+class NEOPIXEL
+{
+};
+
+class CFastLED
+{
+    CLEDController controller;
+    std::atomic<uint8_t> brightness{255};
+    std::atomic<uint32_t> shows{0};
+    CRGB correction = CRGB(0xFFFFFF);
+    CRGB temperature = CRGB(0xFFFFFF);
+
+public:
+    template <template <uint8_t DATA_PIN> class CHIPSET, uint8_t DATA_PIN>
+    CLEDController &addLeds(CRGB *data, int nLedsOrOffset, int nLedsIfOffset = 0)
+    {
+        return controller.setLeds(data + (nLedsIfOffset ? nLedsOrOffset : 0), nLedsIfOffset ? nLedsIfOffset : nLedsOrOffset);
+    }
+    void show()
+    {
+        ++shows;
+    }
+    void setBrightness(uint8_t scale)
+    {
+        brightness = scale;
+    }
+    uint8_t getBrightness()
+    {
+        return brightness;
+    }
+    CFastLED &setCorrection(const CRGB &correction)
+    {
+        this->correction = correction;
+        return *this;
+    }
+    CFastLED &setTemperature(const CRGB &temperature)
+    {
+        this->temperature = temperature;
+        return *this;
+    }
+    CLEDController &operator[](int x)
+    {
+        return controller;
+    }
+    // Host only, the frames handed to the LED driver so far
+    uint32_t getShowCount()
+    {
+        return shows;
+    }
+};
+
+extern CFastLED FastLED;
+
+#endif
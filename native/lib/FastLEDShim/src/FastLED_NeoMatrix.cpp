@@ -0,0 +1,22 @@
+#include "FastLED_NeoMatrix.h"
+
+static void showFastLED()
+{
+    FastLED.show();
+}
+
+FastLED_NeoMatrix::FastLED_NeoMatrix(CRGB *leds, uint8_t w, uint8_t h, uint8_t matrixType)
+    : Framebuffer_GFX(leds, w, h, showFastLED)
+{
+    type = matrixType;
+}
+
+FastLED_NeoMatrix::FastLED_NeoMatrix(CRGB *leds, uint8_t matrixW, uint8_t matrixH, uint8_t tX, uint8_t tY, uint8_t matrixType)
+    : Framebuffer_GFX(leds, matrixW * tX, matrixH * tY, showFastLED)
+{
+    type = matrixType;
+    matrixWidth = matrixW;
+    matrixHeight = matrixH;
+    tilesX = tX;
+    tilesY = tY;
+}
@@ -0,0 +1,22 @@
+#ifndef _FASTLED_NEOMATRIX_H_
+#define _FASTLED_NEOMATRIX_H_
+
+#include "Framebuffer_GFX.h"
+
+class FastLED_NeoMatrix : public Framebuffer_GFX
+{
+public:
+    // Constructor for single matrix
+    FastLED_NeoMatrix(CRGB *, uint8_t w, uint8_t h, uint8_t matrixType = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS);
+
+    // Constructor for tiled matrices
+    FastLED_NeoMatrix(CRGB *, uint8_t matrixW, uint8_t matrixH, uint8_t tX, uint8_t tY,
+                      uint8_t matrixType = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_TILE_TOP + NEO_TILE_LEFT + NEO_TILE_ROWS);
+
+    void setBrightness(int b)
+    {
+        FastLED.setBrightness(b);
+    }
+};
+
+#endif
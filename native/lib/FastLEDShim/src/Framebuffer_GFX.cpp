@@ -0,0 +1,181 @@
+#include "Framebuffer_GFX.h"
+
+#ifndef _swap_uint16_t
+#define _swap_uint16_t(a, b) \
+    {                        \
+        uint16_t t = a;      \
+        a = b;               \
+        b = t;               \
+    }
+#endif
+
+Framebuffer_GFX::Framebuffer_GFX(CRGB *fb, const uint16_t w, const uint16_t h, void (*showptr)())
+    : Adafruit_GFX(w, h), _fb(fb), matrixWidth(w), matrixHeight(h), numpix(w * h), _show(showptr)
+{
+}
+
+uint32_t Framebuffer_GFX::expandColor(uint16_t color)
+{
+    uint8_t r = (color >> 11) & 0x1F;
+    uint8_t g = (color >> 5) & 0x3F;
+    uint8_t b = color & 0x1F;
+    return ((uint32_t)((r << 3) | (r >> 2)) << 16) | ((uint32_t)((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+}
+
+int Framebuffer_GFX::XY(int16_t x, int16_t y)
+{
+    if (remapFn)
+        return (*remapFn)(x, y);
+
+    uint8_t corner = type & NEO_MATRIX_CORNER;
+    uint16_t minor, major, majorScale;
+    uint32_t pixelOffset;
+
+    if (tilesX)
+    {
+        uint16_t tile;
+
+        minor = x / matrixWidth;          // Tile # X/Y; presume row major to
+        major = y / matrixHeight;         // start (will swap later if needed)
+        x = x - (minor * matrixWidth);    // Pixel X/Y within tile
+        y = y - (major * matrixHeight);   // (-* is less math than modulo)
+
+        // Determine corner of entry, flip axes if needed
+        if (type & NEO_TILE_RIGHT)
+            minor = tilesX - 1 - minor;
+        if (type & NEO_TILE_BOTTOM)
+            major = tilesY - 1 - major;
+
+        // Determine actual major axis of tiling
+        if ((type & NEO_TILE_AXIS) == NEO_TILE_ROWS)
+        {
+            majorScale = tilesX;
+        }
+        else
+        {
+            _swap_uint16_t(major, minor);
+            majorScale = tilesY;
+        }
+
+        // Determine tile number
+        if ((type & NEO_TILE_SEQUENCE) == NEO_TILE_PROGRESSIVE)
+        {
+            tile = major * majorScale + minor;
+        }
+        else
+        {
+            // Zigzag; alternate rows change direction. On these rows, this also
+            // flips the starting corner of the matrix for the pixel math later.
+            if (major & 1)
+            {
+                corner ^= NEO_MATRIX_CORNER;
+                tile = (major + 1) * majorScale - 1 - minor;
+            }
+            else
+            {
+                tile = major * majorScale + minor;
+            }
+        }
+
+        pixelOffset = tile * matrixWidth * matrixHeight;
+    }
+    else
+    {
+        pixelOffset = 0;
+    }
+
+    // Determine pixel number within tile/matrix
+    if (corner & NEO_MATRIX_RIGHT)
+        x = matrixWidth - 1 - x;
+    if (corner & NEO_MATRIX_BOTTOM)
+        y = matrixHeight - 1 - y;
+
+    if ((type & NEO_MATRIX_AXIS) == NEO_MATRIX_ROWS)
+    {
+        major = y;
+        minor = x;
+        majorScale = matrixWidth;
+    }
+    else
+    {
+        major = x;
+        minor = y;
+        majorScale = matrixHeight;
+    }
+
+    if ((type & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_PROGRESSIVE)
+    {
+        pixelOffset += major * majorScale + minor;
+    }
+    else
+    {
+        if (major & 1)
+            pixelOffset += (major + 1) * majorScale - 1 - minor;
+        else
+            pixelOffset += major * majorScale + minor;
+    }
+    return pixelOffset;
+}
+
+void Framebuffer_GFX::rotate(int16_t &x, int16_t &y) const
+{
+    int16_t t;
+    switch (rotation)
+    {
+    case 1:
+        t = x;
+        x = WIDTH - 1 - y;
+        y = t;
+        break;
+    case 2:
+        x = WIDTH - 1 - x;
+        y = HEIGHT - 1 - y;
+        break;
+    case 3:
+        t = x;
+        x = y;
+        y = HEIGHT - 1 - t;
+        break;
+    }
+}
+
+void Framebuffer_GFX::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    drawPixel(x, y, passThruFlag ? passThruColor : expandColor(color));
+}
+
+void Framebuffer_GFX::drawPixel(int16_t x, int16_t y, uint32_t color)
+{
+    drawPixel(x, y, CRGB(color));
+}
+
+void Framebuffer_GFX::drawPixel(int16_t x, int16_t y, CRGB color)
+{
+    if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+        return;
+    rotate(x, y);
+    _fb[XY(x, y)] = color;
+}
+
+void Framebuffer_GFX::fillScreen(uint16_t color)
+{
+    CRGB fill(passThruFlag ? passThruColor : expandColor(color));
+    for (uint32_t i = 0; i < numpix; i++)
+        _fb[i] = fill;
+}
+
+void Framebuffer_GFX::setPassThruColor(uint32_t c)
+{
+    passThruColor = c;
+    passThruFlag = true;
+}
+
+void Framebuffer_GFX::setPassThruColor(void)
+{
+    passThruFlag = false;
+}
+
+void Framebuffer_GFX::setRemapFunction(uint16_t (*fn)(uint16_t, uint16_t))
+{
+    remapFn = fn;
+}
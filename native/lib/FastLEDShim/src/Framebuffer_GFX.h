@@ -0,0 +1,94 @@
+#ifndef _FRAMEBUFFER_GFX_H_
+#define _FRAMEBUFFER_GFX_H_
+
+// Adafruit_GFX drawing into a CRGB framebuffer laid out like an Adafruit_NeoMatrix.
+// RGB565 colors are expanded by bit replication, the device library runs them through
+// gamma tables instead, so 16 bit colors come out brighter here. 24 bit colors and the
+// pass-through color are written unchanged on both.
+
+#include "Adafruit_GFX.h"
+#include "FastLED.h"
+
+// Matrix layout: where the first pixel is, rows or columns, progressive or zigzag
+#define NEO_MATRIX_TOP 0x00
+#define NEO_MATRIX_BOTTOM 0x01
+#define NEO_MATRIX_LEFT 0x00
+#define NEO_MATRIX_RIGHT 0x02
+#define NEO_MATRIX_CORNER 0x03
+#define NEO_MATRIX_ROWS 0x00
+#define NEO_MATRIX_COLUMNS 0x04
+#define NEO_MATRIX_AXIS 0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG 0x08
+#define NEO_MATRIX_SEQUENCE 0x08
+
+// Same for the arrangement of tiled matrices
+#define NEO_TILE_TOP 0x00
+#define NEO_TILE_BOTTOM 0x10
+#define NEO_TILE_LEFT 0x00
+#define NEO_TILE_RIGHT 0x20
+#define NEO_TILE_CORNER 0x30
+#define NEO_TILE_ROWS 0x00
+#define NEO_TILE_COLUMNS 0x40
+#define NEO_TILE_AXIS 0x40
+#define NEO_TILE_PROGRESSIVE 0x00
+#define NEO_TILE_ZIGZAG 0x80
+#define NEO_TILE_SEQUENCE 0x80
+
+class Framebuffer_GFX : public Adafruit_GFX
+{
+public:
+    Framebuffer_GFX(CRGB *fb, const uint16_t w, const uint16_t h, void (*showptr)());
+
+    int XY(int16_t x, int16_t y);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void drawPixel(int16_t x, int16_t y, uint32_t color);
+    void drawPixel(int16_t x, int16_t y, CRGB color);
+    void fillScreen(uint16_t color) override;
+    void setPassThruColor(uint32_t c);
+    void setPassThruColor(void);
+    void setRemapFunction(uint16_t (*fn)(uint16_t, uint16_t));
+    void newLedsPtr(CRGB *fb)
+    {
+        _fb = fb;
+    }
+    void show()
+    {
+        if (_show)
+            _show();
+    }
+    void clear()
+    {
+        fillScreen(0);
+    }
+    void begin() {}
+
+    static uint16_t Color(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
+    }
+    static uint16_t Color24to16(uint32_t color)
+    {
+        return ((uint16_t)(((color & 0xFF0000) >> 16) & 0xF8) << 8) | ((uint16_t)(((color & 0x00FF00) >> 8) & 0xFC) << 3) |
+               (((color & 0x0000FF) >> 0) >> 3);
+    }
+    static uint32_t expandColor(uint16_t color);
+
+protected:
+    CRGB *_fb;
+    uint8_t type = 0;
+    uint8_t matrixWidth;
+    uint8_t matrixHeight;
+    uint8_t tilesX = 0;
+    uint8_t tilesY = 0;
+    uint32_t numpix;
+    void (*_show)() = nullptr;
+
+private:
+    void rotate(int16_t &x, int16_t &y) const;
+    uint16_t (*remapFn)(uint16_t x, uint16_t y) = nullptr;
+    uint32_t passThruColor = 0;
+    bool passThruFlag = false;
+};
+
+#endif
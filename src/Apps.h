@@ -2,12 +2,14 @@
 #define AppS_H
 
 #include <vector>
-#include <map>
+#include <algorithm>
 #include "icons.h"
 #include <FastLED_NeoMatrix.h>
 #include "MatrixDisplayUi.h"
 #include "Globals.h"
 #include "Functions.h"
+#include "TextStripCache.h"
+#include "NotificationQueue.h"
 #include "MenuManager.h"
 #include "PeripheryManager.h"
 #include "DisplayManager.h"
@@ -29,11 +31,11 @@ String WEATHER_HUM;
 
 struct CustomApp
 {
-    String drawInstructions;
+    std::vector<uint16_t> drawCommands;
     float scrollposition = 0;
-    int16_t scrollDelay = 0;
+    float scrollDelay = 0; // in target frame intervals
     String text;
-    uint16_t color;
+    CRGB color;
     File icon;
     bool isGif;
     bool rainbow;
@@ -44,6 +46,7 @@ struct CustomApp
     int16_t repeat = 0;
     int16_t currentRepeat = 0;
     String name;
+    uint16_t id = 0;
     byte pushIcon = 0;
     float iconPosition = 0;
     bool iconWasPushed = false;
@@ -53,28 +56,206 @@ struct CustomApp
     int lineSize;
     long lastUpdate;
     int16_t lifetime;
-    std::vector<uint16_t> colors;
+    std::vector<CRGB> colors;
     std::vector<String> fragments;
+    std::vector<uint16_t> fragmentWidths;
+    uint16_t textWidth = 0;
+    bool measuredUppercase = false;
+    uint32_t stripKey = 0;
     int textOffset;
     int progress = -1;
-    uint16_t pColor;
-    uint16_t background = 0;
-    uint16_t pbColor;
+    CRGB pColor;
+    CRGB background = CRGB::Black;
+    CRGB pbColor;
     float scrollSpeed = 100;
     bool topText = true;
     bool noScrolling = true;
+    bool isStatic = false;     // shows the same pixels every frame, drawn from frame
+    CanvasLayer frame;         // rendering of a static app
+    uint32_t frameGeneration = 0;
+    size_t frameBytes = 0;     // charged to staticFrameBytes while the frame is listed
+    uint16_t framePrev = 0;    // neighbours in the list of apps holding a frame, 0 at the ends
+    uint16_t frameNext = 0;
 };
 
-String currentCustomApp;
-std::map<String, CustomApp> customApps;
+// IDs of the native apps, custom apps get theirs from FIRST_CUSTOM_APP_ID on
+enum NativeAppId : uint16_t
+{
+    TIME_APP_ID = 1,
+    DATE_APP_ID,
+    TEMP_APP_ID,
+    HUM_APP_ID,
+    BAT_APP_ID,
+    FIRST_CUSTOM_APP_ID
+};
+
+// Custom apps are kept in a flat pool, the ID of an app is its slot plus
+// FIRST_CUSTOM_APP_ID and unused slots have ID 0. Names are interned when an app
+// is created and only resolved again at the API boundary through customAppNames.
+// It is sorted by name, so all pages of a multi-page app are found by their prefix.
+std::vector<CustomApp> customApps;
+std::vector<uint16_t> freeCustomAppSlots;
+std::vector<std::pair<String, uint16_t>> customAppNames;
+uint16_t currentCustomAppId = 0;
+
+std::vector<std::pair<String, uint16_t>>::iterator lowerBoundCustomAppName(const String &name)
+{
+    return std::lower_bound(customAppNames.begin(), customAppNames.end(), name,
+                            [](const std::pair<String, uint16_t> &entry, const String &name)
+                            { return entry.first < name; });
+}
+
+CustomApp *getCustomAppById(uint16_t id)
+{
+    if (id < FIRST_CUSTOM_APP_ID || id - FIRST_CUSTOM_APP_ID >= customApps.size())
+    {
+        return nullptr;
+    }
+    CustomApp &app = customApps[id - FIRST_CUSTOM_APP_ID];
+    return app.id == id ? &app : nullptr;
+}
+
+CustomApp *getCustomAppByName(const String &name)
+{
+    auto it = lowerBoundCustomAppName(name);
+    return it != customAppNames.end() && it->first == name ? getCustomAppById(it->second) : nullptr;
+}
+
+// IDs of all custom apps whose name starts with prefix, e.g. the pages of a multi-page app
+std::vector<uint16_t> findCustomAppIdsByPrefix(const String &prefix)
+{
+    std::vector<uint16_t> ids;
+    for (auto it = lowerBoundCustomAppName(prefix); it != customAppNames.end() && it->first.startsWith(prefix); ++it)
+    {
+        ids.push_back(it->second);
+    }
+    return ids;
+}
+
+// Interns the name and returns the empty record of the new app. Growing the pool
+// moves every record, so the loop has to be handed to the UI again afterwards.
+CustomApp &createCustomApp(const String &name)
+{
+    uint16_t slot;
+    if (!freeCustomAppSlots.empty())
+    {
+        slot = freeCustomAppSlots.back();
+        freeCustomAppSlots.pop_back();
+    }
+    else
+    {
+        slot = customApps.size();
+        customApps.emplace_back();
+    }
+    CustomApp &app = customApps[slot];
+    app.id = FIRST_CUSTOM_APP_ID + slot;
+    app.name = name;
+    customAppNames.insert(lowerBoundCustomAppName(name), std::make_pair(name, app.id));
+    return app;
+}
+
+// Cached frames of apps stay valid until the app is updated or the generation
+// is bumped because settings or the layout changed
+uint32_t staticFrameGeneration = 1;
+uint32_t staticFrameHits = 0;
+uint32_t staticFrameMisses = 0;
+uint32_t staticFrameEvictions = 0;
+bool renderingStaticFrame = false;
+
+// Custom apps holding a frame, most recently drawn first. They are linked by ID, so the
+// list survives the pool growing, and their bytes are kept as a running total.
+uint16_t staticFrameHead = 0;
+uint16_t staticFrameTail = 0;
+size_t staticFrameBytes = 0;
+
+size_t getStaticFrameBytes()
+{
+    return staticFrameBytes;
+}
+
+void unlinkStaticFrame(CustomApp &app)
+{
+    if (app.framePrev)
+        getCustomAppById(app.framePrev)->frameNext = app.frameNext;
+    else if (staticFrameHead == app.id)
+        staticFrameHead = app.frameNext;
+    if (app.frameNext)
+        getCustomAppById(app.frameNext)->framePrev = app.framePrev;
+    else if (staticFrameTail == app.id)
+        staticFrameTail = app.framePrev;
+    app.framePrev = 0;
+    app.frameNext = 0;
+}
+
+// Charges the current size of the app's frame and moves it to the front of the list
+void useStaticFrame(CustomApp &app)
+{
+    staticFrameBytes = staticFrameBytes - app.frameBytes + app.frame.bytes();
+    app.frameBytes = app.frame.bytes();
+    if (staticFrameHead == app.id)
+        return;
+    unlinkStaticFrame(app);
+    app.frameNext = staticFrameHead;
+    if (staticFrameHead)
+        getCustomAppById(staticFrameHead)->framePrev = app.id;
+    staticFrameHead = app.id;
+    if (!staticFrameTail)
+        staticFrameTail = app.id;
+}
+
+void releaseStaticFrame(CustomApp &app)
+{
+    staticFrameBytes -= app.frameBytes;
+    app.frameBytes = 0;
+    unlinkStaticFrame(app);
+    app.frame.release();
+    app.frameGeneration = 0;
+}
+
+// For a copy of an app, which must neither free nor keep the frame of the original
+void forgetStaticFrame(CustomApp &app)
+{
+    app.frame = CanvasLayer();
+    app.frameGeneration = 0;
+    app.frameBytes = 0;
+    app.framePrev = 0;
+    app.frameNext = 0;
+}
+
+// Frees the frames of the least recently drawn custom apps until required bytes more fit into STATIC_FRAME_SIZE
+void evictStaticFrames(size_t required)
+{
+    while (staticFrameTail && staticFrameBytes + required > STATIC_FRAME_SIZE)
+    {
+        releaseStaticFrame(*getCustomAppById(staticFrameTail));
+        staticFrameEvictions++;
+    }
+}
+
+void eraseCustomApp(uint16_t id)
+{
+    CustomApp *app = getCustomAppById(id);
+    if (app == nullptr)
+    {
+        return;
+    }
+    auto it = lowerBoundCustomAppName(app->name);
+    if (it != customAppNames.end() && it->second == id)
+    {
+        customAppNames.erase(it);
+    }
+    releaseStaticFrame(*app);
+    *app = CustomApp();
+    freeCustomAppSlots.push_back(id - FIRST_CUSTOM_APP_ID);
+}
 
 struct Notification
 {
-    String drawInstructions;
+    std::vector<uint16_t> drawCommands;
     float scrollposition = 34;
-    int16_t scrollDelay = 0;
+    float scrollDelay = 0; // in target frame intervals
     String text;
-    uint16_t color;
+    CRGB color;
     bool soundPlayed = false;
     File icon;
     bool rainbow;
@@ -91,14 +272,18 @@ struct Notification
     int lineData[16] = {0};
     int barSize;
     int lineSize;
-    std::vector<uint16_t> colors;
+    std::vector<CRGB> colors;
     std::vector<String> fragments;
+    std::vector<uint16_t> fragmentWidths;
+    uint16_t textWidth = 0;
+    bool measuredUppercase = false;
+    uint32_t stripKey = 0;
     int textOffset;
     int progress = -1;
-    uint16_t pColor;
+    CRGB pColor;
     int effect;
-    uint16_t background = 0;
-    uint16_t pbColor;
+    CRGB background = CRGB::Black;
+    CRGB pbColor;
     bool wakeup;
     float scrollSpeed = 100;
     bool topText = true;
@@ -106,145 +291,285 @@ struct Notification
     String sound;
     bool loopSound;
     String rtttl;
+    String id;
+    int8_t priority = 0;
+    uint32_t seq = 0;           // assigned by the queue, kept when a notification is replaced
+    unsigned long elapsed = 0; // shown time before a notification with a higher priority took over
 };
-std::vector<Notification> notifications;
-bool notifyFlag = false;
-std::vector<std::pair<String, AppCallback>> Apps;
+NotificationQueue<Notification> notifications(10);
 
-CustomApp *getCustomAppByName(String name)
+// FNV-1a
+uint32_t hashBytes(uint32_t hash, const void *data, size_t length)
 {
-    return customApps.count(name) ? &customApps[name] : nullptr;
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619;
+    }
+    return hash;
 }
 
-String getAppNameByFunction(AppCallback AppFunction)
+// Caches the rendered width of the text and its fragments and the key of its text strip.
+// Needs to be called whenever text, fragments, colors or textCase change.
+template <typename T>
+void measureText(T &app)
 {
-    for (const auto &appPair : Apps)
+    app.fragmentWidths.clear();
+    app.textWidth = 0;
+    for (const String &fragment : app.fragments)
     {
-        if (appPair.second == AppFunction)
-        {
-            return appPair.first;
-        }
+        uint16_t width = getTextWidth(fragment.c_str(), app.textCase);
+        app.fragmentWidths.push_back(width);
+        app.textWidth += width;
     }
+    if (app.fragments.empty())
+    {
+        app.textWidth = getTextWidth(app.text.c_str(), app.textCase);
+    }
+    app.measuredUppercase = UPPERCASE_LETTERS;
 
-    return "";
+    uint32_t key = hashBytes(2166136261, app.text.c_str(), app.text.length());
+    key = hashBytes(key, app.colors.data(), app.colors.size() * sizeof(CRGB));
+    uint8_t style[] = {app.textCase, app.measuredUppercase, app.rainbow, app.color.r, app.color.g, app.color.b};
+    app.stripKey = hashBytes(key, style, sizeof(style));
 }
 
-int findAppIndexByName(const String &name)
+// Draws scrolling text from its pre-rendered strip.
+// Returns false if the text is too long for a strip and has to be printed directly.
+template <typename T>
+bool drawTextStrip(int16_t x, int16_t y, T &app, bool rainbowFragments)
 {
-    auto it = std::find_if(Apps.begin(), Apps.end(), [&name](const std::pair<String, AppCallback> &appPair)
-                           { return appPair.first == name; });
-    if (it != Apps.end())
+    bool rainbow = app.fragments.empty() && app.rainbow;
+    for (size_t i = 0; i < app.fragments.size() && rainbowFragments; ++i)
     {
-        return std::distance(Apps.begin(), it);
+        rainbow |= !app.colors[i];
     }
-    return -1;
+    // Texts too long for a strip are never cached, looking them up would only count misses
+    if (!TextStrips.fits(TextStrip::bytesFor(app.textWidth, rainbow)))
+    {
+        return false;
+    }
+
+    uint32_t key = rainbowFragments ? ~app.stripKey : app.stripKey;
+    TextStrip *strip = TextStrips.find(key, app.text, app.textWidth);
+    if (!strip)
+    {
+        std::vector<TextSegment> segments;
+        if (!app.fragments.empty())
+        {
+            for (size_t i = 0; i < app.fragments.size(); ++i)
+            {
+                segments.push_back({app.fragments[i].c_str(), app.fragmentWidths[i], app.colors[i], rainbowFragments && !app.colors[i]});
+            }
+        }
+        else
+        {
+            segments.push_back({app.text.c_str(), app.textWidth, app.color, app.rainbow});
+        }
+        strip = DisplayManager.renderTextStrip(key, app.text, segments, app.textWidth, app.textCase);
+        if (!strip)
+        {
+            return false;
+        }
+    }
+    DisplayManager.drawTextStrip(x, y, *strip);
+    return true;
 }
 
-void TimeApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+// The global uppercase setting affects every app using textCase 0
+template <typename T>
+uint16_t getCachedTextWidth(T &app)
 {
-    if (notifyFlag)
-        return;
-    CURRENT_APP = "Time";
-
-    if (TIME_COLOR > 0)
+    if (app.measuredUppercase != UPPERCASE_LETTERS)
     {
-        matrix->setTextColor(TIME_COLOR);
+        measureText(app);
     }
-    else
+    return app.textWidth;
+}
+
+// Blits a cached app frame over the framebuffer. An invalid frame is rendered
+// first by calling render, which draws the app at 0,0 into the cleared framebuffer.
+// Only the pixels the app drew are blitted, black ones included.
+template <typename F>
+void drawCachedFrame(CanvasLayer &frame, bool valid, int16_t x, int16_t y, F render)
+{
+    Canvas &canvas = Canvas::getInstance();
+    size_t size = canvas.width() * canvas.height();
+    if (!valid || frame.pixels.size() != size)
     {
-        DisplayManager.getInstance().resetTextColor();
+        std::vector<CRGB> below(size);
+        uint8_t *outer = canvas.beginLayer(frame);
+        canvas.capture(below.data());
+        render();
+        canvas.endLayer(frame, outer);
+        canvas.restore(below.data());
     }
-    time_t now = time(nullptr);
-    struct tm *timeInfo;
-    timeInfo = localtime(&now);
-    const char *timeformat = TIME_FORMAT.c_str();
-    char t[20];
-    char t2[20];
-    if (timeformat[2] == ' ')
+    canvas.blit(x, y, frame);
+}
+
+// Static apps don't scroll and have no GIF, rainbow or effect
+bool isStaticApp(CustomApp &app)
+{
+    uint16_t availableWidth = app.icon ? 24 : 32;
+    bool textFits = app.barSize > 0 || app.lineSize > 0 || getCachedTextWidth(app) <= availableWidth;
+    return app.effect == -1 && !app.rainbow && !(app.icon && app.isGif) && textFits;
+}
+
+void invalidateStaticFrames()
+{
+    staticFrameGeneration++;
+    for (auto &app : customApps)
     {
-        strcpy(t2, timeformat);
-        if (now % 2)
-        {
-            t2[2] = ' ';
-        }
-        else
+        if (app.id)
         {
-            t2[2] = ':';
+            app.isStatic = isStaticApp(app);
         }
-        strftime(t, sizeof(t), t2, localtime(&now));
     }
-    else
+}
+
+bool notifyFlag = false;
+std::vector<AppEntry> Apps;
+
+int findAppIndexByName(const String &name)
+{
+    auto it = std::find_if(Apps.begin(), Apps.end(), [&name](const AppEntry &app)
+                           { return app.name == name; });
+    if (it != Apps.end())
     {
-        strftime(t, sizeof(t), timeformat, localtime(&now));
+        return std::distance(Apps.begin(), it);
     }
+    return -1;
+}
+
+// Formatted text of a clock app. Time zone conversion and strftime only run
+// when the second changes, the frame is only rendered when what it shows changes.
+struct ClockFace
+{
+    time_t second = -1;
+    char text[20] = "";
+    int weekday = 0;
+    uint32_t key = 0;
+    uint32_t generation = 0;
+    CanvasLayer frame;
+};
 
-    DisplayManager.printText(0 + x, 6 + y, t, true, 2);
+ClockFace timeFace;
+ClockFace dateFace;
 
+// Formats the face text if the second or the settings changed since the last call
+template <typename F>
+void updateClockFace(ClockFace &face, F format)
+{
+    time_t now = time(nullptr);
+    if (now == face.second && face.generation == staticFrameGeneration)
+        return;
+    face.second = now;
+    struct tm *timeInfo = localtime(&now);
+    format(now, timeInfo);
+    face.weekday = timeInfo->tm_wday;
+}
+
+// Checks if the face still shows the same as its frame and remembers what it shows now
+bool isClockFaceValid(ClockFace &face, const CRGB &color)
+{
+    uint32_t key = hashBytes(2166136261, face.text, strlen(face.text));
+    uint8_t style[] = {color.r, color.g, color.b,
+                       WDC_ACTIVE.r, WDC_ACTIVE.g, WDC_ACTIVE.b,
+                       WDC_INACTIVE.r, WDC_INACTIVE.g, WDC_INACTIVE.b,
+                       SHOW_WEEKDAY, START_ON_MONDAY, (uint8_t)face.weekday};
+    key = hashBytes(key, style, sizeof(style));
+    bool valid = key == face.key && face.generation == staticFrameGeneration;
+    face.key = key;
+    face.generation = staticFrameGeneration;
+    return valid;
+}
+
+void drawClockFace(const ClockFace &face, const CRGB &color)
+{
+    DisplayManager.setTextColor(color);
+    DisplayManager.printText(0, 6, face.text, true, 2);
     if (!SHOW_WEEKDAY)
         return;
     int dayOffset = START_ON_MONDAY ? 0 : 1;
     for (int i = 0; i <= 6; i++)
     {
-        if (i == (timeInfo->tm_wday + 6 + dayOffset) % 7)
+        if (i == (face.weekday + 6 + dayOffset) % 7)
         {
-            matrix->drawLine((2 + i * 4) + x, y + 7, (i * 4 + 4) + x, y + 7, WDC_ACTIVE);
+            Canvas::getInstance().fillSpan(2 + i * 4, 7, 3, WDC_ACTIVE);
         }
         else
         {
-            matrix->drawLine((2 + i * 4) + x, y + 7, (i * 4 + 4) + x, y + 7, WDC_INACTIVE);
+            Canvas::getInstance().fillSpan(2 + i * 4, 7, 3, WDC_INACTIVE);
         }
     }
 }
 
-void DateApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+void TimeApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context)
 {
     if (notifyFlag)
         return;
-    CURRENT_APP = "Date";
-    if (DATE_COLOR > 0)
-    {
-        matrix->setTextColor(DATE_COLOR);
-    }
-    else
-    {
-        DisplayManager.getInstance().resetTextColor();
-    }
-    time_t now = time(nullptr);
-    struct tm *timeInfo;
-    timeInfo = localtime(&now);
-    char d[20];
-    strftime(d, sizeof(d), DATE_FORMAT.c_str(), localtime(&now));
-    DisplayManager.printText(0 + x, 6 + y, d, true, 2);
-    if (!SHOW_WEEKDAY)
-        return;
-    int dayOffset = START_ON_MONDAY ? 0 : 1;
-    for (int i = 0; i <= 6; i++)
+    CURRENT_APP = "Time";
+
+    auto format = [](time_t now, struct tm *timeInfo)
     {
-        if (i == (timeInfo->tm_wday + 6 + dayOffset) % 7)
+        const char *timeformat = TIME_FORMAT.c_str();
+        if (timeformat[2] == ' ')
         {
-            matrix->drawLine((2 + i * 4) + x, y + 7, (i * 4 + 4) + x, y + 7, WDC_ACTIVE);
+            char t2[20];
+            strlcpy(t2, timeformat, sizeof(t2));
+            if (now % 2)
+            {
+                t2[2] = ' ';
+            }
+            else
+            {
+                t2[2] = ':';
+            }
+            strftime(timeFace.text, sizeof(timeFace.text), t2, timeInfo);
         }
         else
         {
-            matrix->drawLine((2 + i * 4) + x, y + 7, (i * 4 + 4) + x, y + 7, WDC_INACTIVE);
+            strftime(timeFace.text, sizeof(timeFace.text), timeformat, timeInfo);
         }
-    }
+    };
+    updateClockFace(timeFace, format);
+
+    CRGB color = TIME_COLOR ? TIME_COLOR : TEXTCOLOR_888;
+    auto render = [&]()
+    {
+        drawClockFace(timeFace, color);
+    };
+    drawCachedFrame(timeFace.frame, isClockFaceValid(timeFace, color), x, y, render);
 }
 
-void TempApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+void DateApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context)
 {
     if (notifyFlag)
         return;
-    CURRENT_APP = "Temperature";
-    if (TEMP_COLOR > 0)
+    CURRENT_APP = "Date";
+
+    auto format = [](time_t now, struct tm *timeInfo)
     {
-        matrix->setTextColor(TEMP_COLOR);
-    }
-    else
+        strftime(dateFace.text, sizeof(dateFace.text), DATE_FORMAT.c_str(), timeInfo);
+    };
+    updateClockFace(dateFace, format);
+
+    CRGB color = DATE_COLOR ? DATE_COLOR : TEXTCOLOR_888;
+    auto render = [&]()
     {
-        DisplayManager.getInstance().resetTextColor();
-    }
-    matrix->drawRGBBitmap(x, y, icon_234, 8, 8);
+        drawClockFace(dateFace, color);
+    };
+    drawCachedFrame(dateFace.frame, isClockFaceValid(dateFace, color), x, y, render);
+}
+
+void TempApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context)
+{
+    if (notifyFlag)
+        return;
+    CURRENT_APP = "Temperature";
+    Canvas::getInstance().blit(x, y, icon_234, 8, 8);
+    TrueColor textColor(matrix, TEMP_COLOR ? TEMP_COLOR : TEXTCOLOR_888);
 
     if (TEMP_DECIMAL_PLACES > 0)
         matrix->setCursor(8 + x, 6 + y);
@@ -264,20 +589,13 @@ void TempApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x,
     }
 }
 
-void HumApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+void HumApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context)
 {
     if (notifyFlag)
         return;
     CURRENT_APP = "Humidity";
-    if (HUM_COLOR > 0)
-    {
-        matrix->setTextColor(HUM_COLOR);
-    }
-    else
-    {
-        DisplayManager.getInstance().resetTextColor();
-    }
-    matrix->drawRGBBitmap(x, y + 1, icon_2075, 8, 8);
+    Canvas::getInstance().blit(x, y + 1, icon_2075, 8, 8);
+    TrueColor textColor(matrix, HUM_COLOR ? HUM_COLOR : TEXTCOLOR_888);
     matrix->setCursor(14 + x, 6 + y);
     int humidity = CURRENT_HUM;
     matrix->print(humidity);
@@ -285,20 +603,13 @@ void HumApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, i
 }
 
 #ifdef ULANZI
-void BatApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+void BatApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context)
 {
     if (notifyFlag)
         return;
     CURRENT_APP = "Battery";
-    if (BAT_COLOR > 0)
-    {
-        matrix->setTextColor(BAT_COLOR);
-    }
-    else
-    {
-        DisplayManager.getInstance().resetTextColor();
-    }
-    matrix->drawRGBBitmap(x, y, icon_1486, 8, 8);
+    Canvas::getInstance().blit(x, y, icon_1486, 8, 8);
+    TrueColor textColor(matrix, BAT_COLOR ? BAT_COLOR : TEXTCOLOR_888);
     matrix->setCursor(14 + x, 6 + y);
     matrix->print(BATTERY_PERCENT); // Ausgabe des Ladezustands
     matrix->print("%");
@@ -310,7 +621,7 @@ void MenuApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, GifPlayer *
     if (!MenuManager.inMenu)
         return;
     matrix->fillScreen(0);
-    DisplayManager.setTextColor(matrix->Color(255, 255, 255));
+    DisplayManager.setTextColor(CRGB(255, 255, 255));
     DisplayManager.printText(0, 6, utf8ascii(MenuManager.menutext()).c_str(), true, 2);
 }
 
@@ -365,7 +676,7 @@ void TimerApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, GifPlayer
     }
 }
 
-void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+void ShowCustomApp(CustomApp *ca, FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
 {
     // Abort if notifyFlag is set
     if (notifyFlag)
@@ -373,9 +684,6 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
         return;
     }
 
-    // Get custom App by ID
-    CustomApp *ca = getCustomAppByName(name);
-
     // Abort if custom App not found
     if (ca == nullptr)
     {
@@ -396,30 +704,50 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
     }
 
     CURRENT_APP = ca->name;
-    currentCustomApp = name;
+    currentCustomAppId = ca->id;
 
     bool hasIcon = ca->icon;
 
     // matrix->fillRect(x, y, 32, 8, ca->background);
 
     // Calculate text and available width
-    uint16_t textWidth = 0;
-    if (!ca->fragments.empty())
-    {
-        for (const auto &fragment : ca->fragments)
-        {
-            textWidth += getTextWidth(fragment.c_str(), ca->textCase);
-        }
-    }
-    else
-    {
-        textWidth = getTextWidth(ca->text.c_str(), ca->textCase);
-    }
+    uint16_t textWidth = getCachedTextWidth(*ca);
 
     uint16_t availableWidth = (hasIcon) ? 24 : 32;
 
     bool noScrolling = textWidth <= availableWidth;
 
+    Canvas &canvas = Canvas::getInstance();
+    size_t frameBytes = CanvasLayer::bytesFor(canvas.width() * canvas.height());
+    if (ca->isStatic && noScrolling && !renderingStaticFrame && frameBytes <= STATIC_FRAME_SIZE)
+    {
+        bool valid = ca->frameGeneration == staticFrameGeneration;
+        if (valid)
+        {
+            staticFrameHits++;
+            if (ca->barSize == 0 && ca->lineSize == 0)
+            {
+                DisplayManager.setAutoTransition(true);
+            }
+        }
+        else
+        {
+            staticFrameMisses++;
+            releaseStaticFrame(*ca);
+            evictStaticFrames(frameBytes);
+            ca->frameGeneration = staticFrameGeneration;
+        }
+        auto render = [&]()
+        {
+            renderingStaticFrame = true;
+            ShowCustomApp(ca, matrix, state, 0, 0, firstFrame, lastFrame, gifPlayer);
+            renderingStaticFrame = false;
+        };
+        drawCachedFrame(ca->frame, valid, x, y, render);
+        useStaticFrame(*ca);
+        return;
+    }
+
     auto renderIcon = [&]()
     {
         if (ca->pushIcon > 0 && !noScrolling && ca->barSize == 0)
@@ -427,7 +755,7 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
             if (ca->iconPosition < 0 && ca->iconWasPushed == false && ca->scrollposition > 8)
             {
                 if (state->appState == FIXED)
-                    ca->iconPosition += movementFactor;
+                    ca->iconPosition += movementFactor * state->frameScale;
             }
             if (ca->scrollposition < (9-ca->textOffset) && !ca->iconWasPushed)
             {
@@ -468,7 +796,7 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
     }
     else
     {
-        if ((ca->repeat > 0) && (getTextWidth(ca->text.c_str(), ca->textCase) > availableWidth) && (state->appState == FIXED))
+        if ((ca->repeat > 0) && (textWidth > availableWidth) && (state->appState == FIXED))
         {
             DisplayManager.setAutoTransition(false);
         }
@@ -512,17 +840,17 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
                 {
                     if (ca->scrollSpeed == -1)
                     {
-                        ca->scrollposition -= movementFactor * ((float)SCROLL_SPEED / 100);
+                        ca->scrollposition -= movementFactor * state->frameScale * ((float)SCROLL_SPEED / 100);
                     }
                     else
                     {
-                        ca->scrollposition -= movementFactor * (ca->scrollSpeed / 100);
+                        ca->scrollposition -= movementFactor * state->frameScale * (ca->scrollSpeed / 100);
                     }
                 }
             }
             else
             {
-                ++ca->scrollDelay;
+                ca->scrollDelay += state->frameScale;
                 if (hasIcon)
                 {
                     if (ca->iconWasPushed && ca->pushIcon == 1)
@@ -551,9 +879,9 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
                 int16_t fragmentX = textX;
                 for (size_t i = 0; i < ca->fragments.size(); ++i)
                 {
-                    matrix->setTextColor(ca->colors[i]);
+                    DisplayManager.setTextColor(ca->colors[i]);
                     DisplayManager.printText(x + fragmentX, y + 6, ca->fragments[i].c_str(), false, ca->textCase);
-                    fragmentX += getTextWidth(ca->fragments[i].c_str(), ca->textCase);
+                    fragmentX += ca->fragmentWidths[i];
                 }
             }
             else
@@ -565,21 +893,21 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
                 else
                 {
                     // Display text
-                    matrix->setTextColor(ca->color);
+                    DisplayManager.setTextColor(ca->color);
                     DisplayManager.printText(x + textX, y + 6, ca->text.c_str(), false, ca->textCase);
                 }
             }
         }
-        else
+        else if (!drawTextStrip(x + (int16_t)(ca->scrollposition + ca->textOffset), y, *ca, false))
         {
             if (!ca->fragments.empty())
             {
                 int16_t fragmentX = ca->scrollposition + ca->textOffset;
                 for (size_t i = 0; i < ca->fragments.size(); ++i)
                 {
-                    matrix->setTextColor(ca->colors[i]);
+                    DisplayManager.setTextColor(ca->colors[i]);
                     DisplayManager.printText(x + fragmentX, y + 6, ca->fragments[i].c_str(), false, ca->textCase);
-                    fragmentX += getTextWidth(ca->fragments[i].c_str(), ca->textCase);
+                    fragmentX += ca->fragmentWidths[i];
                 }
             }
             else
@@ -590,7 +918,7 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
                 }
                 else
                 {
-                    matrix->setTextColor(ca->color);
+                    DisplayManager.setTextColor(ca->color);
                     DisplayManager.printText(x + ca->scrollposition + ca->textOffset, 6 + y, ca->text.c_str(), false, ca->textCase);
                 }
             }
@@ -602,9 +930,9 @@ void ShowCustomApp(String name, FastLED_NeoMatrix *matrix, MatrixDisplayUiState
         renderIcon();
     }
 
-    if (ca->drawInstructions.length() > 0)
+    if (!ca->drawCommands.empty())
     {
-        DisplayManager.processDrawInstructions(x, y, ca->drawInstructions);
+        DisplayManager.processDrawInstructions(x, y, ca->drawCommands);
     }
 
     if (ca->progress > -1)
@@ -635,22 +963,33 @@ void NotifyApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, GifPlayer
     // Set current app name
     CURRENT_APP = "Notification";
 
-    if (notifications[0].wakeup && MATRIX_OFF)
+    Notification &notification = notifications.front();
+
+    // A notification preempted by one with a higher priority keeps its shown time and continues later
+    static Notification *shown = nullptr;
+    static uint32_t shownSeq = 0;
+    if (notification.seq != shownSeq)
+    {
+        if (shown && shown->seq == shownSeq)
+            shown->elapsed = millis() - shown->startime;
+        notification.startime = millis() - notification.elapsed;
+        shown = &notification;
+        shownSeq = notification.seq;
+    }
+
+    if (notification.wakeup && MATRIX_OFF)
     {
         DisplayManager.setBrightness(BRIGHTNESS);
     }
 
     // Check if notification duration has expired or if repeat count is 0 and hold is not enabled
-    if ((((millis() - notifications[0].startime >= notifications[0].duration) && notifications[0].repeat == -1) || notifications[0].repeat == 0) && !notifications[0].hold)
+    if ((((millis() - notification.startime >= notification.duration) && notification.repeat == -1) || notification.repeat == 0) && !notification.hold)
     {
         // Reset notification flags and exit function
         DEBUG_PRINTLN("Notification deleted");
-        if (notifications.size() >= 2)
-        {
-            notifications[1].startime = millis();
-        }
-        notifications.erase(notifications.begin());
-        if (notifications[0].wakeup && MATRIX_OFF)
+        bool wakeup = notification.wakeup;
+        notifications.pop();
+        if (wakeup && MATRIX_OFF)
         {
             DisplayManager.setBrightness(0);
         }
@@ -658,29 +997,18 @@ void NotifyApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, GifPlayer
     }
 
     // Check if notification has an icon
-    bool hasIcon = notifications[0].icon;
+    bool hasIcon = notification.icon;
 
     // Clear the matrix display
-    matrix->fillRect(0, 0, 32, 8, notifications[0].background);
+    Canvas::getInstance().fillRect(0, 0, 32, 8, notification.background);
 
-    if (!notifications[0].effect>-1)
+    if (!notification.effect>-1)
     {
-        callEffect(matrix, 0, 0, notifications[0].effect);
+        callEffect(matrix, 0, 0, notification.effect);
     }
 
     // Calculate text and available width
-    uint16_t textWidth = 0;
-    if (!notifications[0].fragments.empty())
-    {
-        for (const auto &fragment : notifications[0].fragments)
-        {
-            textWidth += getTextWidth(fragment.c_str(), notifications[0].textCase);
-        }
-    }
-    else
-    {
-        textWidth = getTextWidth(notifications[0].text.c_str(), notifications[0].textCase);
-    }
+    uint16_t textWidth = getCachedTextWidth(notification);
 
     uint16_t availableWidth = hasIcon ? 24 : 32;
 
@@ -690,112 +1018,112 @@ void NotifyApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, GifPlayer
     auto renderIcon = [&]()
     {
         // Push icon if enabled and text is scrolling
-        if (notifications[0].pushIcon > 0 && !noScrolling && notifications[0].barSize == 0)
+        if (notification.pushIcon > 0 && !noScrolling && notification.barSize == 0)
         {
-            if (notifications[0].iconPosition < 0 && notifications[0].iconWasPushed == false && notifications[0].scrollposition > 8)
+            if (notification.iconPosition < 0 && notification.iconWasPushed == false && notification.scrollposition > 8)
             {
-                notifications[0].iconPosition += movementFactor;
+                notification.iconPosition += movementFactor * state->frameScale;
             }
 
-            if (notifications[0].scrollposition < 9 && !notifications[0].iconWasPushed)
+            if (notification.scrollposition < 9 && !notification.iconWasPushed)
             {
-                notifications[0].iconPosition = notifications[0].scrollposition - 9;
+                notification.iconPosition = notification.scrollposition - 9;
 
-                if (notifications[0].iconPosition <= -9)
+                if (notification.iconPosition <= -9)
                 {
-                    notifications[0].iconWasPushed = true;
+                    notification.iconWasPushed = true;
                 }
             }
         }
 
         // Display animated GIF if
-        if (notifications[0].isGif)
+        if (notification.isGif)
         {
             // Display GIF if present
 
-            gifPlayer->playGif(notifications[0].iconPosition, 0, &notifications[0].icon);
+            gifPlayer->playGif(notification.iconPosition, 0, &notification.icon);
         }
         else
         {
             // Display JPG image if present
-            DisplayManager.drawJPG(notifications[0].iconPosition, 0, notifications[0].icon);
+            DisplayManager.drawJPG(notification.iconPosition, 0, notification.icon);
         }
 
         // Display icon divider line if text is scrolling
         if (!noScrolling)
         {
-            matrix->drawLine(8 + notifications[0].iconPosition, 0, 8 + notifications[0].iconPosition, 7, 0);
+            matrix->drawLine(8 + notification.iconPosition, 0, 8 + notification.iconPosition, 7, 0);
         }
     };
 
-    if (hasIcon && notifications[0].topText)
+    if (hasIcon && notification.topText)
     {
         renderIcon();
     }
 
-    if (notifications[0].barSize > 0)
+    if (notification.barSize > 0)
     {
-        DisplayManager.drawBarChart(0, 0, notifications[0].barData, notifications[0].barSize, hasIcon, notifications[0].color);
+        DisplayManager.drawBarChart(0, 0, notification.barData, notification.barSize, hasIcon, notification.color);
     }
-    else if (notifications[0].lineSize > 0)
+    else if (notification.lineSize > 0)
     {
-        DisplayManager.drawLineChart(0, 0, notifications[0].lineData, notifications[0].lineSize, hasIcon, notifications[0].color);
+        DisplayManager.drawLineChart(0, 0, notification.lineData, notification.lineSize, hasIcon, notification.color);
     }
     else
     {
         // Check if text needs to be scrolled
-        if (textWidth > availableWidth && notifications[0].scrollposition <= -textWidth)
+        if (textWidth > availableWidth && notification.scrollposition <= -textWidth)
         {
             // Reset scroll position and icon position if needed
-            notifications[0].scrollDelay = 0;
-            notifications[0].scrollposition = 9 + notifications[0].textOffset;
+            notification.scrollDelay = 0;
+            notification.scrollposition = 9 + notification.textOffset;
 
-            if (notifications[0].pushIcon == 2)
+            if (notification.pushIcon == 2)
             {
-                notifications[0].iconWasPushed = false;
+                notification.iconWasPushed = false;
             }
 
-            if (notifications[0].repeat > 0)
+            if (notification.repeat > 0)
             {
-                --notifications[0].repeat;
-                if (notifications[0].repeat == 0)
+                --notification.repeat;
+                if (notification.repeat == 0)
                     return;
             }
         }
 
         if (!noScrolling)
         {
-            if ((notifications[0].scrollDelay > MATRIX_FPS * 1.2) || ((hasIcon ? notifications[0].textOffset + 9 : notifications[0].textOffset) > 31))
+            if ((notification.scrollDelay > MATRIX_FPS * 1.2) || ((hasIcon ? notification.textOffset + 9 : notification.textOffset) > 31))
             {
-                if (!notifications[0].noScrolling)
+                if (!notification.noScrolling)
                 {
-                    if (notifications[0].scrollSpeed == -1)
+                    if (notification.scrollSpeed == -1)
                     {
-                        notifications[0].scrollposition -= movementFactor * ((float)SCROLL_SPEED / 100);
+                        notification.scrollposition -= movementFactor * state->frameScale * ((float)SCROLL_SPEED / 100);
                     }
                     else
                     {
-                        notifications[0].scrollposition -= movementFactor * (notifications[0].scrollSpeed / 100);
+                        notification.scrollposition -= movementFactor * state->frameScale * (notification.scrollSpeed / 100);
                     }
                 }
             }
             else
             {
-                ++notifications[0].scrollDelay;
+                notification.scrollDelay += state->frameScale;
                 if (hasIcon)
                 {
-                    if (notifications[0].iconWasPushed && notifications[0].pushIcon == 1)
+                    if (notification.iconWasPushed && notification.pushIcon == 1)
                     {
-                        notifications[0].scrollposition = 0 + notifications[0].textOffset;
+                        notification.scrollposition = 0 + notification.textOffset;
                     }
                     else
                     {
-                        notifications[0].scrollposition = 9 + notifications[0].textOffset;
+                        notification.scrollposition = 9 + notification.textOffset;
                     }
                 }
                 else
                 {
-                    notifications[0].scrollposition = 0 + notifications[0].textOffset;
+                    notification.scrollposition = 0 + notification.textOffset;
                 }
             }
         }
@@ -804,236 +1132,120 @@ void NotifyApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, GifPlayer
         int16_t textX = hasIcon ? ((24 - textWidth) / 2) + 9 : ((32 - textWidth) / 2);
 
         // Set text color
-        matrix->setTextColor(notifications[0].color);
+        DisplayManager.setTextColor(notification.color);
 
         if (noScrolling)
         {
             // Disable repeat if text is not scrolling
-            notifications[0].repeat = -1;
+            notification.repeat = -1;
 
-            if (!notifications[0].fragments.empty())
+            if (!notification.fragments.empty())
             {
-                int16_t fragmentX = textX + notifications[0].textOffset;
-                for (size_t i = 0; i < notifications[0].fragments.size(); ++i)
+                int16_t fragmentX = textX + notification.textOffset;
+                for (size_t i = 0; i < notification.fragments.size(); ++i)
                 {
-                    if (notifications[0].colors[i] == 0)
+                    if (!notification.colors[i])
                     {
-                        DisplayManager.HSVtext(fragmentX, 6, notifications[0].fragments[i].c_str(), false, notifications[0].textCase);
+                        DisplayManager.HSVtext(fragmentX, 6, notification.fragments[i].c_str(), false, notification.textCase);
                     }
                     else
                     {
-                        matrix->setTextColor(notifications[0].colors[i]);
-                        DisplayManager.printText(fragmentX, 6, notifications[0].fragments[i].c_str(), false, notifications[0].textCase);
+                        DisplayManager.setTextColor(notification.colors[i]);
+                        DisplayManager.printText(fragmentX, 6, notification.fragments[i].c_str(), false, notification.textCase);
                     }
 
-                    fragmentX += getTextWidth(notifications[0].fragments[i].c_str(), notifications[0].textCase);
+                    fragmentX += notification.fragmentWidths[i];
                 }
             }
             else
             {
-                if (notifications[0].rainbow)
+                if (notification.rainbow)
                 {
-                    DisplayManager.HSVtext(textX + notifications[0].textOffset, 6, notifications[0].text.c_str(), false, notifications[0].textCase);
+                    DisplayManager.HSVtext(textX + notification.textOffset, 6, notification.text.c_str(), false, notification.textCase);
                 }
                 else
                 {
-                    DisplayManager.printText(textX + notifications[0].textOffset, 6, notifications[0].text.c_str(), false, notifications[0].textCase);
+                    DisplayManager.printText(textX + notification.textOffset, 6, notification.text.c_str(), false, notification.textCase);
                 }
             }
         }
-        else
+        else if (!drawTextStrip(notification.scrollposition, 0, notification, true))
         {
-            if (!notifications[0].fragments.empty())
+            if (!notification.fragments.empty())
             {
-                int16_t fragmentX = notifications[0].scrollposition;
-                for (size_t i = 0; i < notifications[0].fragments.size(); ++i)
+                int16_t fragmentX = notification.scrollposition;
+                for (size_t i = 0; i < notification.fragments.size(); ++i)
                 {
-                    if (notifications[0].colors[i] == 0)
+                    if (!notification.colors[i])
                     {
-                        DisplayManager.HSVtext(fragmentX, 6, notifications[0].fragments[i].c_str(), false, notifications[0].textCase);
+                        DisplayManager.HSVtext(fragmentX, 6, notification.fragments[i].c_str(), false, notification.textCase);
                     }
                     else
                     {
-                        matrix->setTextColor(notifications[0].colors[i]);
-                        DisplayManager.printText(fragmentX, 6, notifications[0].fragments[i].c_str(), false, notifications[0].textCase);
+                        DisplayManager.setTextColor(notification.colors[i]);
+                        DisplayManager.printText(fragmentX, 6, notification.fragments[i].c_str(), false, notification.textCase);
                     }
-                    fragmentX += getTextWidth(notifications[0].fragments[i].c_str(), notifications[0].textCase);
+                    fragmentX += notification.fragmentWidths[i];
                 }
             }
             else
             {
-                if (notifications[0].rainbow)
+                if (notification.rainbow)
                 {
                     // Display scrolling text in rainbow color if enabled
-                    DisplayManager.HSVtext(notifications[0].scrollposition, 6, notifications[0].text.c_str(), false, notifications[0].textCase);
+                    DisplayManager.HSVtext(notification.scrollposition, 6, notification.text.c_str(), false, notification.textCase);
                 }
                 else
                 {
                     // Display scrolling text in solid color
-                    DisplayManager.printText(notifications[0].scrollposition, 6, notifications[0].text.c_str(), false, notifications[0].textCase);
+                    DisplayManager.printText(notification.scrollposition, 6, notification.text.c_str(), false, notification.textCase);
                 }
             }
         }
     }
 
     // Display icon if present and not pushed
-    if (hasIcon && !notifications[0].topText)
+    if (hasIcon && !notification.topText)
     {
         renderIcon();
     }
 
-    if (notifications[0].progress > -1)
+    if (notification.progress > -1)
     {
-        DisplayManager.drawProgressBar((hasIcon ? 9 : 0), 7, notifications[0].progress, notifications[0].pColor, notifications[0].pbColor);
+        DisplayManager.drawProgressBar((hasIcon ? 9 : 0), 7, notification.progress, notification.pColor, notification.pbColor);
     }
 
-    if (notifications[0].drawInstructions.length() > 0)
+    if (!notification.drawCommands.empty())
     {
-        DisplayManager.processDrawInstructions(0, 0, notifications[0].drawInstructions);
+        DisplayManager.processDrawInstructions(0, 0, notification.drawCommands);
     }
 
-    if (!notifications[0].soundPlayed || notifications[0].loopSound)
+    if (!notification.soundPlayed || notification.loopSound)
     {
          if (!PeripheryManager.isPlaying()){
-        if (notifications[0].sound != "" || (MATRIX_OFF && notifications[0].wakeup))
+        if (notification.sound != "" || (MATRIX_OFF && notification.wakeup))
         {
-            PeripheryManager.playFromFile(notifications[0].sound);
+            PeripheryManager.playFromFile(notification.sound);
         }
 
-        if (notifications[0].rtttl != "")
+        if (notification.rtttl != "")
         {
-            PeripheryManager.playRTTTLString(notifications[0].rtttl);
+            PeripheryManager.playRTTTLString(notification.rtttl);
         }
           }
-        notifications[0].soundPlayed = true;
+        notification.soundPlayed = true;
     }
 
     // Reset text color after displaying notification
     DisplayManager.getInstance().resetTextColor();
 }
 
-// Unattractive to have a function for every customapp wich does the same, but currently still no other option found TODO
-
-void CApp1(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp1);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp2(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp2);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp3(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp3);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp4(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp4);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp5(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp5);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp6(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp6);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp7(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp7);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp8(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp8);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp9(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp9);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp10(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp10);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp11(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp11);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp12(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp12);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp13(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp13);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp14(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp14);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp15(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp15);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp16(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp16);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp17(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp17);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp18(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp18);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp19(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
-{
-    String name = getAppNameByFunction(CApp19);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
-}
-
-void CApp20(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+// Shared by all custom apps, the context is the CustomApp to show
+void CustomAppCallback(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context)
 {
-    String name = getAppNameByFunction(CApp20);
-    ShowCustomApp(name, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
+    ShowCustomApp((CustomApp *)context, matrix, state, x, y, firstFrame, lastFrame, gifPlayer);
 }
 
 OverlayCallback overlays[] = {MenuApp, NotifyApp, AlarmApp, TimerApp};
-void (*customAppCallbacks[20])(FastLED_NeoMatrix *, MatrixDisplayUiState *, int16_t, int16_t, bool, bool, GifPlayer *) = {CApp1, CApp2, CApp3, CApp4, CApp5, CApp6, CApp7, CApp8, CApp9, CApp10, CApp11, CApp12, CApp13, CApp14, CApp15, CApp16, CApp17, CApp18, CApp19, CApp20};
+const char *const overlayNames[] = {"overlay:Menu", "overlay:Notify", "overlay:Alarm", "overlay:Timer"};
 #endif
\ No newline at end of file
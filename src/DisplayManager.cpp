@@ -15,6 +15,12 @@
 #include <set>
 #include "GifPlayer.h"
 #include <ArtnetWifi.h>
+#include "IconCache.h"
+#include "TextStripCache.h"
+#include <atomic>
+#include "Profiler.h"
+#include "Canvas.h"
+#include "JsonArena.h"
 
 Ticker AlarmTicker;
 Ticker TimerTicker;
@@ -44,6 +50,53 @@ GifPlayer gif;
 uint16_t gifX, gifY;
 CRGB leds[MATRIX_WIDTH * MATRIX_HEIGHT];
 
+// State of the last transmitted frame
+CRGB shownLeds[MATRIX_WIDTH * MATRIX_HEIGHT];
+uint8_t shownBrightness;
+CRGB shownCorrection;
+CRGB shownTemperature;
+
+// Triple buffered LED output. The UI composes into leds, show() copies the frame into
+// the free slot and publishes it with a single atomic exchange. The output task on the
+// other core picks up the latest published slot, so neither side ever waits for the other.
+#define FRAME_SLOT_DIRTY 0x80
+CRGB frameSlots[3][MATRIX_WIDTH * MATRIX_HEIGHT];
+std::atomic<uint32_t> pendingSlot(1);
+uint8_t writeSlot = 0; // owned by the composing task
+uint8_t readSlot = 2;  // owned by the output task
+CLEDController *ledController;
+TaskHandle_t outputTaskHandle = NULL;
+
+void outputTask(void *parameter)
+{
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (pendingSlot.load() & FRAME_SLOT_DIRTY)
+        {
+            readSlot = pendingSlot.exchange(readSlot) & ~FRAME_SLOT_DIRTY;
+            ledController->setLeds(frameSlots[readSlot], MATRIX_WIDTH * MATRIX_HEIGHT);
+        }
+        PROFILE_STAGE("output");
+        FastLED.show();
+    }
+}
+
+TaskHandle_t bootAnimationHandle = NULL;
+volatile bool bootAnimationStop = false;
+volatile bool bootAnimationRunning = false;
+
+void bootAnimationTask(void *parameter)
+{
+    while (!bootAnimationStop)
+    {
+        DisplayManager.HSVtext(4, 6, "AWTRIX", true, 0);
+        vTaskDelay(1);
+    }
+    bootAnimationRunning = false;
+    vTaskDelete(NULL);
+}
+
 // BMP Creation
 const int w = 32;             // image width in pixels
 const int h = 8;              // " height
@@ -66,10 +119,10 @@ DisplayManager_ &DisplayManager = DisplayManager.getInstance();
 
 void DisplayManager_::setBrightness(int bri)
 {
-    bool wakeup;
+    bool wakeup = false;
     if (!notifications.empty())
     {
-        wakeup = notifications[0].wakeup;
+        wakeup = notifications.front().wakeup;
     }
 
     if (MATRIX_OFF && !ALARM_ACTIVE && !wakeup)
@@ -83,9 +136,12 @@ void DisplayManager_::setBrightness(int bri)
     }
 }
 
-void DisplayManager_::setTextColor(uint16_t color)
+// Color used by printText, drawn through TrueColor so it never passes through RGB565
+static CRGB textColor;
+
+void DisplayManager_::setTextColor(const CRGB &color)
 {
-    matrix->setTextColor(color);
+    textColor = color;
 }
 
 bool DisplayManager_::setAutoTransition(bool active)
@@ -110,12 +166,21 @@ bool DisplayManager_::setAutoTransition(bool active)
 
 void DisplayManager_::drawJPG(uint16_t x, uint16_t y, fs::File jpgFile)
 {
-    TJpgDec.drawFsJpg(x, y, jpgFile);
+    uint8_t width, height;
+    const uint16_t *pixels = IconCache.get(jpgFile, width, height);
+    if (pixels)
+    {
+        Canvas::getInstance().blit(x, y, pixels, width, height);
+    }
+    else
+    {
+        TJpgDec.drawFsJpg(x, y, jpgFile);
+    }
 }
 
 void DisplayManager_::drawBMP(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h)
 {
-    matrix->drawRGBBitmap(y, x, bitmap, w, h);
+    Canvas::getInstance().blit(y, x, bitmap, w, h);
 }
 
 void DisplayManager_::applyAllSettings()
@@ -123,39 +188,41 @@ void DisplayManager_::applyAllSettings()
     ui->setTargetFPS(MATRIX_FPS);
     ui->setTimePerApp(TIME_PER_APP);
     ui->setTimePerTransition(TIME_PER_TRANSITION);
+    ui->setTransitionEffect((TransitionEffect)TRANSITION_EFFECT);
 
     if (!AUTO_BRIGHTNESS)
         setBrightness(BRIGHTNESS);
-    setTextColor(TEXTCOLOR_565);
+    setTextColor(TEXTCOLOR_888);
     setAutoTransition(AUTO_TRANSITION);
+    invalidateStaticFrames();
+}
+
+// Static app frames have icons and settings baked in, they are rendered again on their next draw
+void DisplayManager_::invalidateStaticFrames()
+{
+    ::invalidateStaticFrames();
 }
 
 void DisplayManager_::resetTextColor()
 {
-    matrix->setTextColor(TEXTCOLOR_565);
+    textColor = TEXTCOLOR_888;
 }
 
 void DisplayManager_::clearMatrix()
 {
     matrix->clear();
-    matrix->show();
+    show();
 }
 
 bool jpg_output(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap)
 {
-    uint16_t bitmapIndex = 0;
-    for (uint16_t row = 0; row < h; row++)
-    {
-        for (uint16_t col = 0; col < w; col++)
-        {
-            matrix->drawPixel(x + col, y + row, bitmap[bitmapIndex++]);
-        }
-    }
+    Canvas::getInstance().blit(x, y, bitmap, w, h);
     return 0;
 }
 
 void DisplayManager_::printText(int16_t x, int16_t y, const char *text, bool centered, byte textCase)
 {
+    TrueColor color(matrix, textColor);
 
     if (centered)
     {
@@ -187,82 +254,146 @@ void DisplayManager_::printText(int16_t x, int16_t y, const char *text, bool cen
     }
 }
 
+static uint8_t hueOffset = 0;
+
 void DisplayManager_::HSVtext(int16_t x, int16_t y, const char *text, bool clear, byte textCase)
 {
     if (clear)
         matrix->clear();
-    static uint8_t hueOffset = 0;
     uint16_t xpos = 0;
-    for (uint16_t i = 0; i < strlen(text); i++)
+    bool upperCase = (UPPERCASE_LETTERS && textCase == 0) || textCase == 1;
+    const uint8_t *advances = getGlyphAdvances(textCase);
+    size_t length = strlen(text);
+    for (size_t i = 0; i < length; i++)
     {
-        uint8_t hue = map(i, 0, strlen(text), 0, 255) + hueOffset;
-        uint32_t textColor = hsvToRgb(hue, 255, 255);
-        matrix->setTextColor(textColor);
-        const char *myChar = &text[i];
-
+        uint8_t hue = map(i, 0, length, 0, 255) + hueOffset;
+        TrueColor color(matrix, hsvToRgb(hue, 255, 255));
         matrix->setCursor(xpos + x, y);
-        if ((UPPERCASE_LETTERS && textCase == 0) || textCase == 1)
-        {
-            matrix->print((char)toupper(text[i]));
-        }
-        else
-        {
-            matrix->print(&text[i]);
-        }
-        char temp_str[2] = {'\0', '\0'};
-        temp_str[0] = text[i];
-        xpos += getTextWidth(temp_str, textCase);
+        matrix->write(upperCase ? toupper((uint8_t)text[i]) : text[i]);
+        xpos += advances[(uint8_t)text[i]];
     }
     hueOffset++;
     if (clear)
-        matrix->show();
+        show();
 }
 
-void pushCustomApp(String name, int position)
-{
-    if (customApps.count(name) == 0)
-    {
-        int availableCallbackIndex = -1;
-
-        for (int i = 0; i < 20; ++i)
-        {
-            bool callbackUsed = false;
-
-            for (const auto &appPair : Apps)
-            {
-                if (appPair.second == customAppCallbacks[i])
-                {
-                    callbackUsed = true;
-                    break;
-                }
-            }
-
-            if (!callbackUsed)
+TextStrip *DisplayManager_::renderTextStrip(uint32_t key, const String &text, const std::vector<TextSegment> &segments, uint16_t width, byte textCase)
+{
+    bool rainbow = false;
+    for (const TextSegment &segment : segments)
+        rainbow |= segment.rainbow;
+
+    // Too long texts are rendered directly
+    if (!TextStrips.fits(TextStrip::bytesFor(width, rainbow)))
+        return nullptr;
+
+    GFXcanvas1 canvas(width, 8);
+    if (!canvas.getBuffer())
+        return nullptr;
+    canvas.setFont(&AwtrixFont);
+    canvas.setTextWrap(false);
+
+    TextStrip strip;
+    strip.key = key;
+    strip.text = text;
+    strip.width = width;
+    strip.columns.assign(width, 0);
+    strip.colors.assign(width, CRGB::Black);
+    if (rainbow)
+        strip.hues.assign(width, -1);
+
+    bool upperCase = (UPPERCASE_LETTERS && textCase == 0) || textCase == 1;
+    const uint8_t *advances = getGlyphAdvances(textCase);
+    uint16_t cursor = 0;
+    for (const TextSegment &segment : segments)
+    {
+        canvas.setCursor(cursor, 6);
+        size_t length = strlen(segment.text);
+        uint16_t column = cursor;
+        for (size_t i = 0; i < length; i++)
+        {
+            uint8_t c = segment.text[i];
+            canvas.write(upperCase ? toupper(c) : c);
+            // Same hue per character as HSVtext
+            int16_t hue = segment.rainbow ? (uint8_t)map(i, 0, length, 0, 255) : -1;
+            for (uint8_t a = 0; a < advances[c] && column < width; a++, column++)
             {
-                availableCallbackIndex = i;
-                break;
+                strip.colors[column] = segment.color;
+                if (rainbow)
+                    strip.hues[column] = hue;
             }
         }
+        cursor += segment.width;
+    }
 
-        if (availableCallbackIndex == -1)
+    for (uint16_t x = 0; x < width; x++)
+    {
+        for (uint8_t y = 0; y < 8; y++)
         {
-            DEBUG_PRINTLN("Error adding custom app -> Maximum number of custom apps reached");
-            return;
+            if (canvas.getPixel(x, y))
+                strip.columns[x] |= 1 << y;
         }
+    }
+    return TextStrips.insert(std::move(strip));
+}
 
-        if (position < 0) // Insert at the end of the vector
-        {
-            Apps.push_back(std::make_pair(name, customAppCallbacks[availableCallbackIndex]));
-        }
-        else if (position < Apps.size()) // Insert at a specific position
+void DisplayManager_::drawTextStrip(int16_t x, int16_t y, const TextStrip &strip)
+{
+    // Only the columns inside the visible window are touched
+    Canvas &canvas = Canvas::getInstance();
+    int16_t first = x < 0 ? -x : 0;
+    int16_t last = min((int)strip.width, matrix->width() - x);
+    bool rainbow = !strip.hues.empty();
+    for (int16_t column = first; column < last; column++)
+    {
+        uint8_t bits = strip.columns[column];
+        if (!bits)
+            continue;
+        CRGB color = strip.colors[column];
+        if (rainbow && strip.hues[column] >= 0)
+            color = hsvToRgb(strip.hues[column] + hueOffset, 255, 255);
+        for (uint8_t row = 0; row < 8; row++)
         {
-            Apps.insert(Apps.begin() + position, std::make_pair(name, customAppCallbacks[availableCallbackIndex]));
+            if (bits & (1 << row))
+                canvas.setPixel(x + column, y + row, color);
         }
-        else // Invalid position, Insert at the end of the vector
+    }
+    if (rainbow)
+        hueOffset++;
+}
+
+// Points the loop entries of custom apps at their records again, needed after the pool grew
+void refreshCustomAppContexts()
+{
+    for (AppEntry &entry : Apps)
+    {
+        if (entry.callback == CustomAppCallback)
         {
-            Apps.push_back(std::make_pair(name, customAppCallbacks[availableCallbackIndex]));
+            entry.context = getCustomAppById(entry.id);
         }
+    }
+}
+
+// Adds a new custom app to the loop, the entry points to the app itself
+void pushCustomApp(CustomApp &app, int position, bool setApps)
+{
+    refreshCustomAppContexts();
+    AppEntry entry(app.name, CustomAppCallback, app.id, &app);
+    if (position < 0) // Insert at the end of the vector
+    {
+        Apps.push_back(entry);
+    }
+    else if (position < Apps.size()) // Insert at a specific position
+    {
+        Apps.insert(Apps.begin() + position, entry);
+    }
+    else // Invalid position, Insert at the end of the vector
+    {
+        Apps.push_back(entry);
+    }
 
+    if (setApps)
+    {
         ui->setApps(Apps); // Add Apps
         DisplayManager.getInstance().setAutoTransition(true);
     }
@@ -293,60 +424,43 @@ bool deleteCustomAppFile(const String &name)
     }
 }
 
-void removeCustomAppFromApps(const String &name, bool setApps)
+// Takes the apps from the loop and the pool without touching the UI or the saved file
+void eraseCustomAppsByPrefix(const String &name)
 {
+    // All pages of a multi-page app share the name as prefix
+    std::vector<uint16_t> ids = findCustomAppIdsByPrefix(name);
+
     // Remove apps from Apps list
-    auto it = Apps.begin();
-    while (it != Apps.end())
+    auto removed = [&ids](const AppEntry &app)
     {
-        if (it->first.startsWith(name))
-        {
-            it = Apps.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
+        return app.callback == CustomAppCallback && std::find(ids.begin(), ids.end(), app.id) != ids.end();
+    };
+    Apps.erase(std::remove_if(Apps.begin(), Apps.end(), removed), Apps.end());
 
-    // Remove apps from customApps map
-    auto mapIt = customApps.begin();
-    while (mapIt != customApps.end())
+    // Remove apps from the pool
+    for (uint16_t id : ids)
     {
-        if (mapIt->first.startsWith(name))
-        {
-            mapIt = customApps.erase(mapIt);
-        }
-        else
-        {
-            ++mapIt;
-        }
+        eraseCustomApp(id);
     }
+}
 
+void removeCustomAppFromApps(const String &name, bool setApps)
+{
+    eraseCustomAppsByPrefix(name);
     if (setApps)
         ui->setApps(Apps);
     DisplayManager.getInstance().setAutoTransition(true);
     deleteCustomAppFile(name);
 }
 
-bool parseFragmentsText(const String &jsonText, std::vector<uint16_t> &colors, std::vector<String> &fragments, uint16_t standardColor)
+void parseFragments(JsonArrayConst fragmentArray, std::vector<CRGB> &colors, std::vector<String> &fragments, const CRGB &standardColor)
 {
     colors.clear();
     fragments.clear();
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, jsonText);
-    if (error)
-    {
-        doc.clear();
-        return false;
-    }
-
-    JsonArray fragmentArray = doc.as<JsonArray>();
-
-    for (JsonObject fragmentObj : fragmentArray)
+    for (JsonObjectConst fragmentObj : fragmentArray)
     {
         String textFragment = fragmentObj["t"].as<String>();
-        uint16_t color;
+        CRGB color;
         if (fragmentObj.containsKey("c"))
         {
             auto fragColor = fragmentObj["c"];
@@ -360,10 +474,70 @@ bool parseFragmentsText(const String &jsonText, std::vector<uint16_t> &colors, s
         fragments.push_back(textFragment);
         colors.push_back(color);
     }
-    doc.clear();
+}
+
+bool parseFragmentsText(const String &jsonText, std::vector<CRGB> &colors, std::vector<String> &fragments, const CRGB &standardColor)
+{
+    colors.clear();
+    fragments.clear();
+    JsonLease lease(ARENA_FRAGMENTS);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(jsonText);
+    if (error)
+    {
+        return false;
+    }
+
+    parseFragments(doc.as<JsonArray>(), colors, fragments, standardColor);
     return true;
 }
 
+// Reads the text of a payload. Colored fragments come straight from the parsed payload
+// instead of parsing the serialized text a second time.
+void parseText(JsonVariantConst text, String &plainText, std::vector<CRGB> &colors, std::vector<String> &fragments, const CRGB &standardColor)
+{
+    plainText = utf8ascii(text.as<String>());
+    if (text.is<JsonArrayConst>())
+    {
+        parseFragments(text.as<JsonArrayConst>(), colors, fragments, standardColor);
+        for (String &fragment : fragments)
+            fragment = utf8ascii(fragment);
+    }
+    else
+    {
+        parseFragmentsText(plainText, colors, fragments, standardColor);
+    }
+}
+
+// Reads up to 16 chart values, optionally scaled to the matrix height, and returns how many were read
+int parseChartData(JsonArrayConst data, int values[16], bool autoscale)
+{
+    int size = 0;
+    int maximum = 0;
+    for (JsonVariantConst v : data)
+    {
+        if (size >= 16)
+        {
+            break;
+        }
+        int d = v.as<int>();
+        if (d > maximum)
+        {
+            maximum = d;
+        }
+        values[size++] = d;
+    }
+
+    if (autoscale)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            values[j] = map(values[j], 0, maximum, 0, 8);
+        }
+    }
+    return size;
+}
+
 bool DisplayManager_::parseCustomPage(const String &name, const char *json)
 {
     if ((strcmp(json, "") == 0) || (strcmp(json, "{}") == 0))
@@ -371,54 +545,73 @@ bool DisplayManager_::parseCustomPage(const String &name, const char *json)
         removeCustomAppFromApps(name, true);
         return true;
     }
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
     {
-        doc.clear();
         return false;
     }
 
+    bool parsed = true;
     if (doc.is<JsonObject>())
     {
         DEBUG_PRINTLN("Single Page");
-        return generateCustomPage(name, json, false);
+        parsed = generateCustomPage(name, doc.as<JsonObjectConst>(), false, true);
     }
     else if (doc.is<JsonArray>())
     {
-        JsonArray customPagesArray = doc.as<JsonArray>();
+        // Every page is built from the parsed payload, new pages join the loop together afterwards
+        size_t appCount = Apps.size();
         int cpIndex = 0;
-        for (JsonVariant customPage : customPagesArray)
+        for (JsonObjectConst customPage : doc.as<JsonArrayConst>())
         {
             Serial.printf("Multiple Page: %i", cpIndex);
-            JsonObject customPageObject = customPage.as<JsonObject>();
-            String customPageJson;
-            serializeJson(customPageObject, customPageJson);
-            generateCustomPage(name + String(cpIndex), customPageJson.c_str(), false);
+            generateCustomPage(name + String(cpIndex), customPage, false, false);
             ++cpIndex;
         }
+        if (Apps.size() != appCount)
+        {
+            ui->setApps(Apps);
+            setAutoTransition(true);
+        }
     }
-    doc.clear();
-    return true;
+    return parsed;
 }
 
 bool DisplayManager_::generateCustomPage(const String &name, const char *json, bool preventSave)
 {
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
     {
         DEBUG_PRINTLN("PARSING FAILED");
         DEBUG_PRINTLN(error.c_str());
-        doc.clear();
+        return false;
+    }
+    bool parsed = generateCustomPage(name, doc.as<JsonObjectConst>(), preventSave, true);
+    return parsed;
+}
+
+// Builds or updates a custom app from one page. setApps = false leaves adding a new app
+// to the running loop to the caller, so several pages can be committed at once.
+bool DisplayManager_::generateCustomPage(const String &name, JsonObjectConst doc, bool preventSave, bool setApps)
+{
+    std::vector<uint16_t> drawCommands;
+    if (doc.containsKey("draw") && !compileDrawInstructions(doc["draw"], drawCommands))
+    {
+        DEBUG_PRINTLN("Invalid draw instructions");
         return false;
     }
 
     CustomApp customApp;
 
-    if (customApps.find(name) != customApps.end())
+    CustomApp *existingApp = getCustomAppByName(name);
+    if (existingApp != nullptr)
     {
-        customApp = customApps[name];
+        customApp = *existingApp;
+        forgetStaticFrame(customApp);
     }
 
     customApp.progress = doc.containsKey("progress") ? doc["progress"].as<int>() : -1;
@@ -426,7 +619,7 @@ bool DisplayManager_::generateCustomPage(const String &name, const char *json, b
     if (doc.containsKey("background"))
     {
         auto background = doc["background"];
-        customApp.background = getColorFromJsonVariant(background, 0);
+        customApp.background = getColorFromJsonVariant(background, CRGB::Black);
     }
 
     if (doc.containsKey("save") && preventSave == false)
@@ -460,21 +653,21 @@ bool DisplayManager_::generateCustomPage(const String &name, const char *json, b
     if (doc.containsKey("progressC"))
     {
         auto progressC = doc["progressC"];
-        customApp.pColor = getColorFromJsonVariant(progressC, matrix->Color(0, 255, 0));
+        customApp.pColor = getColorFromJsonVariant(progressC, CRGB(0, 255, 0));
     }
     else
     {
-        customApp.pColor = matrix->Color(0, 255, 0);
+        customApp.pColor = CRGB(0, 255, 0);
     }
 
     if (doc.containsKey("progressBC"))
     {
         auto progressBC = doc["progressBC"];
-        customApp.pbColor = getColorFromJsonVariant(progressBC, matrix->Color(255, 255, 255));
+        customApp.pbColor = getColorFromJsonVariant(progressBC, CRGB(255, 255, 255));
     }
     else
     {
-        customApp.pbColor = matrix->Color(255, 255, 255);
+        customApp.pbColor = CRGB(255, 255, 255);
     }
 
     bool autoscale = true;
@@ -483,83 +676,10 @@ bool DisplayManager_::generateCustomPage(const String &name, const char *json, b
         autoscale = doc["autoscale"].as<bool>();
     }
 
-    if (doc.containsKey("bar"))
-    {
-        JsonArray barData = doc["bar"];
-        int i = 0;
-        int maximum = 0;
-        for (JsonVariant v : barData)
-        {
-            if (i >= 16)
-            {
-                break;
-            }
-            int d = v.as<int>();
-            if (d > maximum)
-            {
-                maximum = d;
-            }
-            customApp.barData[i] = d;
-            i++;
-        }
-        customApp.barSize = i;
-
-        if (autoscale)
-        {
-            for (int j = 0; j < customApp.barSize; j++)
-            {
-                customApp.barData[j] = map(customApp.barData[j], 0, maximum, 0, 8);
-            }
-        }
-    }
-    else
-    {
-        customApp.barSize = 0;
-    }
-
-    if (doc.containsKey("line"))
-    {
-        JsonArray lineData = doc["line"];
-        int i = 0;
-        int maximum = 0;
-        for (JsonVariant v : lineData)
-        {
-            if (i >= 16)
-            {
-                break;
-            }
-            int d = v.as<int>();
-            if (d > maximum)
-            {
-                maximum = d;
-            }
-            customApp.lineData[i] = d;
-            i++;
-        }
-        customApp.lineSize = i;
-
-        // Autoscaling
-        if (autoscale)
-        {
-            for (int j = 0; j < customApp.lineSize; j++)
-            {
-                customApp.lineData[j] = map(customApp.lineData[j], 0, maximum, 0, 8);
-            }
-        }
-    }
-    else
-    {
-        customApp.lineSize = 0;
-    }
+    customApp.barSize = doc.containsKey("bar") ? parseChartData(doc["bar"], customApp.barData, autoscale) : 0;
+    customApp.lineSize = doc.containsKey("line") ? parseChartData(doc["line"], customApp.lineData, autoscale) : 0;
 
-    if (doc.containsKey("draw"))
-    {
-        customApp.drawInstructions = doc["draw"].as<String>();
-    }
-    else
-    {
-        customApp.drawInstructions = "";
-    }
+    customApp.drawCommands = std::move(drawCommands);
 
     customApp.effect = doc.containsKey("effect") ? getEffectIndex(doc["effect"].as<String>()) : -1;
     customApp.duration = doc.containsKey("duration") ? doc["duration"].as<long>() * 1000 : 0;
@@ -579,25 +699,24 @@ bool DisplayManager_::generateCustomPage(const String &name, const char *json, b
     if (doc.containsKey("color"))
     {
         auto color = doc["color"];
-        customApp.color = getColorFromJsonVariant(color, TEXTCOLOR_565);
+        customApp.color = getColorFromJsonVariant(color, TEXTCOLOR_888);
     }
     else
     {
-        customApp.color = TEXTCOLOR_565;
+        customApp.color = TEXTCOLOR_888;
     }
 
     if (doc.containsKey("text"))
     {
-        String text = utf8ascii(doc["text"].as<String>());
-        parseFragmentsText(text, customApp.colors, customApp.fragments, customApp.color);
-        customApp.text = text;
+        parseText(doc["text"], customApp.text, customApp.colors, customApp.fragments, customApp.color);
     }
     else
     {
         customApp.text = "";
     }
+    measureText(customApp);
 
-    if (currentCustomApp != name)
+    if (customApp.id == 0 || customApp.id != currentCustomAppId)
     {
         customApp.scrollposition = 9 + customApp.textOffset;
     }
@@ -636,6 +755,11 @@ bool DisplayManager_::generateCustomPage(const String &name, const char *json, b
                 customApp.icon = nullPointer;
             }
         }
+        if (customApp.icon && !customApp.isGif)
+        {
+            uint8_t width, height;
+            IconCache.get(customApp.icon, width, height);
+        }
     }
     else
     {
@@ -643,21 +767,130 @@ bool DisplayManager_::generateCustomPage(const String &name, const char *json, b
         customApp.icon = nullPointer;
     }
 
-    pushCustomApp(name, pos - 1);
-    customApps[name] = customApp;
-    doc.clear();
+    customApp.isStatic = isStaticApp(customApp);
+
+    CustomApp *storedApp = getCustomAppByName(name);
+    if (storedApp == nullptr)
+    {
+        storedApp = &createCustomApp(name);
+        customApp.id = storedApp->id;
+        *storedApp = std::move(customApp);
+        pushCustomApp(*storedApp, pos - 1, setApps);
+    }
+    else
+    {
+        releaseStaticFrame(*storedApp);
+        *storedApp = std::move(customApp);
+    }
     DEBUG_PRINTLN("PARSING FINISHED");
     return true;
 }
 
+// Applies only the supplied keys to an existing custom app. Icon, effect, position and the
+// saved file stay untouched, so frequent updates skip the icon lookup and the flash write.
+bool DisplayManager_::patchCustomPage(const String &name, const char *json)
+{
+    CustomApp *app = getCustomAppByName(name);
+    if (app == nullptr)
+    {
+        return false;
+    }
+
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
+    if (error || !doc.is<JsonObject>())
+    {
+        DEBUG_PRINTLN("PARSING FAILED");
+        return false;
+    }
+
+    if (doc.containsKey("draw"))
+    {
+        std::vector<uint16_t> drawCommands;
+        if (!compileDrawInstructions(doc["draw"], drawCommands))
+        {
+            DEBUG_PRINTLN("Invalid draw instructions");
+            return false;
+        }
+        app->drawCommands = std::move(drawCommands);
+    }
+
+    if (doc.containsKey("progress"))
+        app->progress = doc["progress"].as<int>();
+    if (doc.containsKey("progressC"))
+        app->pColor = getColorFromJsonVariant(doc["progressC"], CRGB(0, 255, 0));
+    if (doc.containsKey("progressBC"))
+        app->pbColor = getColorFromJsonVariant(doc["progressBC"], CRGB(255, 255, 255));
+    if (doc.containsKey("background"))
+        app->background = getColorFromJsonVariant(doc["background"], CRGB::Black);
+
+    bool autoscale = doc.containsKey("autoscale") ? doc["autoscale"].as<bool>() : true;
+    if (doc.containsKey("bar"))
+        app->barSize = parseChartData(doc["bar"], app->barData, autoscale);
+    if (doc.containsKey("line"))
+        app->lineSize = parseChartData(doc["line"], app->lineData, autoscale);
+
+    if (doc.containsKey("duration"))
+        app->duration = doc["duration"].as<long>() * 1000;
+    if (doc.containsKey("rainbow"))
+        app->rainbow = doc["rainbow"];
+    if (doc.containsKey("pushIcon"))
+        app->pushIcon = doc["pushIcon"];
+    if (doc.containsKey("textCase"))
+        app->textCase = doc["textCase"];
+    if (doc.containsKey("lifetime"))
+        app->lifetime = doc["lifetime"];
+    if (doc.containsKey("textOffset"))
+        app->textOffset = doc["textOffset"];
+    if (doc.containsKey("scrollSpeed"))
+        app->scrollSpeed = doc["scrollSpeed"].as<int>();
+    if (doc.containsKey("topText"))
+        app->topText = doc["topText"].as<bool>();
+    if (doc.containsKey("noScroll"))
+        app->noScrolling = doc["noScroll"];
+    if (doc.containsKey("repeat"))
+        app->repeat = doc["repeat"].as<int>();
+    if (app->noScrolling)
+        app->repeat = -1;
+
+    if (doc.containsKey("color"))
+        app->color = getColorFromJsonVariant(doc["color"], TEXTCOLOR_888);
+
+    if (doc.containsKey("text"))
+    {
+        parseText(doc["text"], app->text, app->colors, app->fragments, app->color);
+    }
+    else if (doc.containsKey("color") && !app->fragments.empty())
+    {
+        // Fragments without their own color follow the text color
+        parseFragmentsText(app->text, app->colors, app->fragments, app->color);
+    }
+
+    if (doc.containsKey("text") || doc.containsKey("color") || doc.containsKey("textCase") || doc.containsKey("rainbow"))
+        measureText(*app);
+
+    app->lastUpdate = millis();
+    app->isStatic = isStaticApp(*app);
+    releaseStaticFrame(*app);
+    return true;
+}
+
 bool DisplayManager_::generateNotification(uint8_t source, const char *json)
 {
     // source: 0=MQTT, 1=HTTP
-    StaticJsonDocument<4096> doc;
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
     {
-        doc.clear();
+        return false;
+    }
+
+    std::vector<uint16_t> drawCommands;
+    if (doc.containsKey("draw") && !compileDrawInstructions(doc["draw"], drawCommands))
+    {
+        DEBUG_PRINTLN("Invalid draw instructions");
         return false;
     }
 
@@ -668,37 +901,30 @@ bool DisplayManager_::generateNotification(uint8_t source, const char *json)
     if (doc.containsKey("progressC"))
     {
         auto progressC = doc["progressC"];
-        newNotification.pColor = getColorFromJsonVariant(progressC, matrix->Color(0, 255, 0));
+        newNotification.pColor = getColorFromJsonVariant(progressC, CRGB(0, 255, 0));
     }
     else
     {
-        newNotification.pColor = matrix->Color(0, 255, 0);
+        newNotification.pColor = CRGB(0, 255, 0);
     }
 
     if (doc.containsKey("progressBC"))
     {
         auto progressBC = doc["progressBC"];
-        newNotification.pbColor = getColorFromJsonVariant(progressBC, matrix->Color(255, 255, 255));
+        newNotification.pbColor = getColorFromJsonVariant(progressBC, CRGB(255, 255, 255));
     }
     else
     {
-        newNotification.pbColor = matrix->Color(255, 255, 255);
+        newNotification.pbColor = CRGB(255, 255, 255);
     }
 
     if (doc.containsKey("background"))
     {
         auto background = doc["background"];
-        newNotification.background = getColorFromJsonVariant(background, 0);
+        newNotification.background = getColorFromJsonVariant(background, CRGB::Black);
     }
 
-    if (doc.containsKey("draw"))
-    {
-        newNotification.drawInstructions = doc["draw"].as<String>();
-    }
-    else
-    {
-        newNotification.drawInstructions = "";
-    }
+    newNotification.drawCommands = std::move(drawCommands);
     newNotification.loopSound = doc.containsKey("loopSound") ? doc["loopSound"].as<bool>() : false;
     newNotification.effect = doc.containsKey("effect") ? getEffectIndex(doc["effect"].as<String>()) : -1;
     newNotification.sound = doc.containsKey("sound") ? doc["sound"].as<String>() : "";
@@ -707,6 +933,8 @@ bool DisplayManager_::generateNotification(uint8_t source, const char *json)
 
     newNotification.rainbow = doc.containsKey("rainbow") ? doc["rainbow"].as<bool>() : false;
     newNotification.hold = doc.containsKey("hold") ? doc["hold"].as<bool>() : false;
+    newNotification.id = doc.containsKey("id") ? doc["id"].as<String>() : "";
+    newNotification.priority = doc.containsKey("priority") ? constrain(doc["priority"].as<int>(), -128, 127) : 0;
     newNotification.scrollSpeed = doc.containsKey("scrollSpeed") ? doc["scrollSpeed"].as<int>() : -1;
     newNotification.wakeup = doc.containsKey("wakeup") ? doc["wakeup"].as<bool>() : false;
     newNotification.pushIcon = doc.containsKey("pushIcon") ? doc["pushIcon"] : 0;
@@ -802,23 +1030,22 @@ bool DisplayManager_::generateNotification(uint8_t source, const char *json)
     if (doc.containsKey("color"))
     {
         auto color = doc["color"];
-        newNotification.color = getColorFromJsonVariant(color, TEXTCOLOR_565);
+        newNotification.color = getColorFromJsonVariant(color, TEXTCOLOR_888);
     }
     else
     {
-        newNotification.color = TEXTCOLOR_565;
+        newNotification.color = TEXTCOLOR_888;
     }
 
     if (doc.containsKey("text"))
     {
-        String text = utf8ascii(doc["text"].as<String>());
-        parseFragmentsText(text, newNotification.colors, newNotification.fragments, newNotification.color);
-        newNotification.text = text;
+        parseText(doc["text"], newNotification.text, newNotification.colors, newNotification.fragments, newNotification.color);
     }
     else
     {
         newNotification.text = "";
     }
+    measureText(newNotification);
 
     if (doc.containsKey("icon"))
     {
@@ -838,6 +1065,11 @@ bool DisplayManager_::generateNotification(uint8_t source, const char *json)
             fs::File nullPointer;
             newNotification.icon = nullPointer;
         }
+        if (newNotification.icon && !newNotification.isGif)
+        {
+            uint8_t width, height;
+            IconCache.get(newNotification.icon, width, height);
+        }
     }
     else
     {
@@ -871,25 +1103,33 @@ bool DisplayManager_::generateNotification(uint8_t source, const char *json)
     CURRENT_APP = "Notification";
     MQTTManager.setCurrentApp(CURRENT_APP);
 
+    // An update of the notification on screen only replaces its content. It keeps scrolling
+    // from where it is, doesn't play its sound again and doesn't restart its duration.
+    if (!newNotification.id.isEmpty() && !notifications.empty() && notifications.front().id == newNotification.id)
+    {
+        const Notification &shown = notifications.front();
+        newNotification.soundPlayed = shown.soundPlayed;
+        newNotification.startime = shown.startime;
+        newNotification.elapsed = shown.elapsed;
+        newNotification.scrollposition = shown.scrollposition;
+        newNotification.scrollDelay = shown.scrollDelay;
+        newNotification.iconPosition = shown.iconPosition;
+        newNotification.iconWasPushed = shown.iconWasPushed;
+        if (newNotification.repeat > -1 && shown.repeat > -1)
+            newNotification.repeat = shown.repeat;
+    }
+
     bool stack = doc.containsKey("stack") ? doc["stack"] : true;
 
     if (stack)
     {
-        notifications.push_back(newNotification);
+        notifications.push(std::move(newNotification));
     }
     else
     {
-        if (notifications.empty())
-        {
-            notifications.push_back(newNotification);
-        }
-        else
-        {
-            notifications[0] = newNotification;
-        }
+        notifications.replaceFront(std::move(newNotification));
     }
 
-    doc.clear();
     return true;
 }
 
@@ -936,10 +1176,10 @@ void DisplayManager_::loadCustomApps()
 void DisplayManager_::loadNativeApps()
 {
     // Define a helper function to check and update an app
-    auto updateApp = [&](const String &name, AppCallback callback, bool show, size_t position)
+    auto updateApp = [&](const String &name, AppCallback callback, uint16_t id, bool show, size_t position)
     {
-        auto it = std::find_if(Apps.begin(), Apps.end(), [&](const std::pair<String, AppCallback> &app)
-                               { return app.first == name; });
+        auto it = std::find_if(Apps.begin(), Apps.end(), [&](const AppEntry &app)
+                               { return app.id == id; });
         if (it != Apps.end())
         {
             if (!show)
@@ -953,26 +1193,26 @@ void DisplayManager_::loadNativeApps()
             {
                 if (position >= Apps.size())
                 {
-                    Apps.push_back(std::make_pair(name, callback));
+                    Apps.emplace_back(name, callback, id);
                 }
                 else
                 {
-                    Apps.insert(Apps.begin() + position, std::make_pair(name, callback));
+                    Apps.insert(Apps.begin() + position, AppEntry(name, callback, id));
                 }
             }
         }
     };
 
-    updateApp("time", TimeApp, SHOW_TIME, 0);
-    updateApp("date", DateApp, SHOW_DATE, 1);
+    updateApp("time", TimeApp, TIME_APP_ID, SHOW_TIME, 0);
+    updateApp("date", DateApp, DATE_APP_ID, SHOW_DATE, 1);
 
     if (SENSOR_READING)
     {
-        updateApp("temp", TempApp, SHOW_TEMP, 2);
-        updateApp("hum", HumApp, SHOW_HUM, 3);
+        updateApp("temp", TempApp, TEMP_APP_ID, SHOW_TEMP, 2);
+        updateApp("hum", HumApp, HUM_APP_ID, SHOW_HUM, 3);
     }
 #ifdef ULANZI
-    updateApp("bat", BatApp, SHOW_BAT, 4);
+    updateApp("bat", BatApp, BAT_APP_ID, SHOW_BAT, 4);
 #endif
 
     ui->setApps(Apps);
@@ -983,10 +1223,16 @@ void DisplayManager_::setup()
 {
     TJpgDec.setCallback(jpg_output);
     TJpgDec.setJpgScale(1);
+    IconCache.setBudget(ICON_CACHE_SIZE);
+    TextStrips.setBudget(TEXT_STRIP_SIZE);
+    GifCache::getInstance().setBudget(GIF_CACHE_SIZE);
+    JsonArena.setSize(JSON_ARENA_SIZE);
+    notifications.setCapacity(NOTIFICATION_QUEUE_SIZE);
+    notifications.setOverflow((QueueOverflow)NOTIFICATION_OVERFLOW);
     random16_set_seed(millis());
-    FastLED.addLeds<NEOPIXEL, MATRIX_PIN>(leds, MATRIX_WIDTH * MATRIX_HEIGHT);
+    ledController = &FastLED.addLeds<NEOPIXEL, MATRIX_PIN>(frameSlots[readSlot], MATRIX_WIDTH * MATRIX_HEIGHT);
+    xTaskCreatePinnedToCore(outputTask, "LedOutput", 4096, NULL, 2, &outputTaskHandle, 0);
     setMatrixLayout(MATRIX_LAYOUT);
-    matrix->setRotation(ROTATE_SCREEN ? 90 : 0);
     if (COLOR_CORRECTION)
     {
         FastLED.setCorrection(COLOR_CORRECTION);
@@ -1001,7 +1247,8 @@ void DisplayManager_::setup()
     ui->setTargetFPS(MATRIX_FPS);
     ui->setTimePerApp(TIME_PER_APP);
     ui->setTimePerTransition(TIME_PER_TRANSITION);
-    ui->setOverlays(overlays, 4);
+    ui->setTransitionEffect((TransitionEffect)TRANSITION_EFFECT);
+    ui->setOverlays(overlays, overlayNames, 4);
     ui->setBackgroundEffect(BACKGROUND_EFFECT);
     setAutoTransition(AUTO_TRANSITION);
     ui->init();
@@ -1009,15 +1256,9 @@ void DisplayManager_::setup()
 
 void ResetCustomApps()
 {
-    if (customApps.empty())
-    {
-        return;
-    }
-
-    for (auto it = customApps.begin(); it != customApps.end(); ++it)
+    for (CustomApp &app : customApps)
     {
-        CustomApp &app = it->second;
-        if (app.name != currentCustomApp)
+        if (app.id && app.id != currentCustomAppId)
         {
             app.iconWasPushed = false;
             app.scrollposition = (app.icon ? 9 : 0) + app.textOffset;
@@ -1027,9 +1268,9 @@ void ResetCustomApps()
     }
 }
 
-void checkLifetime(uint8_t pos)
+void checkLifetime(uint16_t pos)
 {
-    if (customApps.empty())
+    if (customAppNames.empty())
     {
         return;
     }
@@ -1039,20 +1280,20 @@ void checkLifetime(uint8_t pos)
         pos = 0;
     }
 
-    String appName = Apps[pos].first;
-    auto appIt = customApps.find(appName);
+    if (Apps[pos].callback != CustomAppCallback)
+    {
+        return;
+    }
 
-    if (appIt != customApps.end())
+    CustomApp &app = *(CustomApp *)Apps[pos].context;
+    if (app.lifetime > 0 && (millis() - app.lastUpdate) / 1000 >= app.lifetime)
     {
-        CustomApp &app = appIt->second;
-        if (app.lifetime > 0 && (millis() - app.lastUpdate) / 1000 >= app.lifetime)
-        {
-            DEBUG_PRINTLN("Removing " + appName + " -> Lifetime over");
-            removeCustomAppFromApps(appName, false);
+        String appName = app.name;
+        DEBUG_PRINTLN("Removing " + appName + " -> Lifetime over");
+        removeCustomAppFromApps(appName, false);
 
-            DEBUG_PRINTLN("Set new Apploop");
-            ui->setApps(Apps);
-        }
+        DEBUG_PRINTLN("Set new Apploop");
+        ui->setApps(Apps);
     }
 }
 
@@ -1114,7 +1355,7 @@ void onDmxFrame(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t *d
     if (universe == 10)
     {
         matrix->setBrightness(data[0]);
-        matrix->show();
+        DisplayManager.show();
     }
 
     // Store which universe has got in
@@ -1132,17 +1373,18 @@ void onDmxFrame(uint16_t universe, uint16_t length, uint8_t sequence, uint8_t *d
     }
 
     // read universe and put into the right part of the display buffer
+    Canvas &canvas = Canvas::getInstance();
     for (int i = 0; i < length / 3; i++)
     {
         int led = i + (universe - startUniverse) * (previousDataLength / 3);
         if (led < 256)
-            matrix->drawPixel(led % matrix->width(), led / matrix->width(), matrix->Color(data[i * 3], data[i * 3 + 1], data[i * 3 + 2]));
+            canvas.setPixel(led % canvas.width(), led / canvas.width(), CRGB(data[i * 3], data[i * 3 + 1], data[i * 3 + 2]));
     }
     previousDataLength = length;
 
     if (sendFrame)
     {
-        matrix->show();
+        DisplayManager.show();
         // Reset universeReceived to 0
         memset(universesReceived, 0, maxUniverses);
     }
@@ -1161,7 +1403,44 @@ void DisplayManager_::clear()
 
 void DisplayManager_::show()
 {
-    matrix->show();
+    memcpy(frameSlots[writeSlot], leds, sizeof(leds));
+    writeSlot = pendingSlot.exchange(writeSlot | FRAME_SLOT_DIRTY) & ~FRAME_SLOT_DIRTY;
+    xTaskNotifyGive(outputTaskHandle);
+    memcpy(shownLeds, leds, sizeof(leds));
+    shownBrightness = FastLED.getBrightness();
+    shownCorrection = COLOR_CORRECTION;
+    shownTemperature = COLOR_TEMPERATURE;
+    ++framesShown;
+}
+
+// Runs the boot animation in its own task until stopBootAnimation is called.
+// Nothing else may draw while it is running.
+void DisplayManager_::startBootAnimation()
+{
+    bootAnimationStop = false;
+    bootAnimationRunning = true;
+    xTaskCreatePinnedToCore(bootAnimationTask, "BootAnimation", 10000, NULL, 1, &bootAnimationHandle, 0);
+}
+
+// Returns once the boot animation task has finished its last frame
+void DisplayManager_::stopBootAnimation()
+{
+    bootAnimationStop = true;
+    while (bootAnimationRunning)
+    {
+        delay(1);
+    }
+}
+
+// Transmits the frame only if pixels, brightness or color correction changed since the last one
+void DisplayManager_::showFrame()
+{
+    if (memcmp(shownLeds, leds, sizeof(leds)) == 0 && shownBrightness == FastLED.getBrightness() && shownCorrection == COLOR_CORRECTION && shownTemperature == COLOR_TEMPERATURE)
+    {
+        ++framesSkipped;
+        return;
+    }
+    show();
 }
 
 void DisplayManager_::leftButton()
@@ -1234,12 +1513,12 @@ void DisplayManager_::selectButtonLong()
 void DisplayManager_::dismissNotify()
 {
 
-    bool wakeup;
+    bool wakeup = false;
 
     if (!notifications.empty())
     {
-        wakeup = notifications[0].wakeup;
-        notifications.erase(notifications.begin());
+        wakeup = notifications.front().wakeup;
+        notifications.pop();
         PeripheryManager.stopSound();
     }
 
@@ -1266,8 +1545,9 @@ void timerCallback()
 
 void DisplayManager_::gererateTimer(String Payload)
 {
-    DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, Payload);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(Payload);
     if (error)
         return;
     int hours = doc["hours"] | 0;
@@ -1286,8 +1566,9 @@ void DisplayManager_::gererateTimer(String Payload)
 
 bool DisplayManager_::switchToApp(const char *json)
 {
-    DynamicJsonDocument doc(512);
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
         return false;
     String name = doc["name"].as<String>();
@@ -1304,14 +1585,14 @@ bool DisplayManager_::switchToApp(const char *json)
     }
 }
 
-void DisplayManager_::drawProgressBar(int16_t x, int16_t y, int progress, uint16_t pColor, uint16_t pbColor)
+void DisplayManager_::drawProgressBar(int16_t x, int16_t y, int progress, const CRGB &pColor, const CRGB &pbColor)
 {
     int available_length = 32 - x;
     int leds_for_progress = (progress * available_length) / 100;
-    matrix->drawFastHLine(x, y, available_length, pbColor);
-    Serial.println(leds_for_progress);
+    Canvas &canvas = Canvas::getInstance();
+    canvas.fillSpan(x, y, available_length, pbColor);
     if (leds_for_progress > 0)
-        matrix->drawFastHLine(x, y, leds_for_progress, pColor);
+        canvas.fillSpan(x, y, leds_for_progress, pColor);
 }
 
 void DisplayManager_::drawMenuIndicator(int cur, int total, uint16_t color)
@@ -1334,7 +1615,7 @@ void DisplayManager_::drawMenuIndicator(int cur, int total, uint16_t color)
     }
 }
 
-void DisplayManager_::drawBarChart(int16_t x, int16_t y, const int newData[], byte dataSize, bool withIcon, uint16_t color)
+void DisplayManager_::drawBarChart(int16_t x, int16_t y, const int newData[], byte dataSize, bool withIcon, const CRGB &color)
 {
     int availableWidth = withIcon ? (32 - 9) : 32;
     int gap = 1;
@@ -1350,13 +1631,14 @@ void DisplayManager_::drawBarChart(int16_t x, int16_t y, const int newData[], by
 
         if (barHeight > 0)
         {
-            matrix->fillRect(x1, y1 + y, barWidth, barHeight, color);
+            Canvas::getInstance().fillRect(x1, y1 + y, barWidth, barHeight, color);
         }
     }
 }
 
-void DisplayManager_::drawLineChart(int16_t x, int16_t y, const int newData[], byte dataSize, bool withIcon, uint16_t color)
+void DisplayManager_::drawLineChart(int16_t x, int16_t y, const int newData[], byte dataSize, bool withIcon, const CRGB &color)
 {
+    TrueColor lineColor(matrix, color);
     int availableWidth = withIcon ? (32 - 9) : 32;
     int startX = withIcon ? 9 : 0;
     float xStep = static_cast<float>(availableWidth) / static_cast<float>(dataSize - 1);
@@ -1366,48 +1648,48 @@ void DisplayManager_::drawLineChart(int16_t x, int16_t y, const int newData[], b
     {
         int x1 = x + startX + static_cast<int>(xStep * i);
         int y1 = y + 8 - newData[i];
-        matrix->drawLine(lastX, lastY, x1, y1, color);
+        matrix->drawLine(lastX, lastY, x1, y1, 0);
         lastX = x1;
         lastY = y1;
     }
 }
 
-std::pair<String, AppCallback> getNativeAppByName(const String &appName)
+AppEntry getNativeAppByName(const String &appName)
 {
     if (appName == "time")
     {
-        return std::make_pair("time", TimeApp);
+        return AppEntry("time", TimeApp, TIME_APP_ID);
     }
     else if (appName == "date")
     {
-        return std::make_pair("date", DateApp);
+        return AppEntry("date", DateApp, DATE_APP_ID);
     }
     else if (appName == "temp")
     {
-        return std::make_pair("temp", TempApp);
+        return AppEntry("temp", TempApp, TEMP_APP_ID);
     }
     else if (appName == "hum")
     {
-        return std::make_pair("hum", HumApp);
+        return AppEntry("hum", HumApp, HUM_APP_ID);
     }
 #ifdef ULANZI
     else if (appName == "bat")
     {
-        return std::make_pair("bat", BatApp);
+        return AppEntry("bat", BatApp, BAT_APP_ID);
     }
 #endif
-    return std::make_pair("", nullptr);
+    return AppEntry("", nullptr, 0);
 }
 
 void DisplayManager_::updateAppVector(const char *json)
 {
     DEBUG_PRINTLN(F("New apps vector received"));
     DEBUG_PRINTLN(json);
-    DynamicJsonDocument doc(2048);
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
     {
-        doc.clear();
         DEBUG_PRINTLN(F("Failed to parse json"));
         return;
     }
@@ -1430,10 +1712,10 @@ void DisplayManager_::updateAppVector(const char *json)
         bool show = appObj["show"].as<bool>();
         int position = appObj.containsKey("pos") ? appObj["pos"].as<int>() : Apps.size();
 
-        auto appIt = std::find_if(Apps.begin(), Apps.end(), [&appName](const std::pair<String, AppCallback> &app)
-                                  { return app.first == appName; });
+        auto appIt = std::find_if(Apps.begin(), Apps.end(), [&appName](const AppEntry &app)
+                                  { return app.name == appName; });
 
-        std::pair<String, AppCallback> nativeApp = getNativeAppByName(appName);
+        AppEntry nativeApp = getNativeAppByName(appName);
 
         if (!show)
         {
@@ -1444,7 +1726,7 @@ void DisplayManager_::updateAppVector(const char *json)
         }
         else
         {
-            if (nativeApp.second != nullptr)
+            if (nativeApp.callback != nullptr)
             {
                 if (appIt != Apps.end())
                 {
@@ -1458,7 +1740,7 @@ void DisplayManager_::updateAppVector(const char *json)
             {
                 if (appIt != Apps.end() && appObj.containsKey("pos"))
                 {
-                    std::pair<String, AppCallback> app = *appIt;
+                    AppEntry app = *appIt;
                     Apps.erase(appIt);
                     position = position < 0 ? 0 : position >= Apps.size() ? Apps.size()
                                                                           : position;
@@ -1473,12 +1755,95 @@ void DisplayManager_::updateAppVector(const char *json)
     saveSettings();
     sendAppLoop();
     setAutoTransition(AUTO_TRANSITION);
-    doc.clear();
 }
 
+#ifdef PERF_PROFILING
+// Renders every loaded app and every effect for the given number of frames into the
+// framebuffer without showing them. Reports the throughput and a hash of the last frame,
+// which only stays the same between builds for scenarios that don't depend on time or randomness.
+String DisplayManager_::runBenchmark(uint16_t frames)
+{
+    DynamicJsonDocument doc(4096);
+    doc[F("frames")] = frames;
+    JsonArray scenarios = doc.createNestedArray(F("scenarios"));
+    MatrixDisplayUiState *state = ui->getUiState();
+    bool wasSwitching = appIsSwitching;
+    appIsSwitching = true; // keeps apps from changing the app time
+
+    auto measure = [&](const String &name, const char *type, std::function<void()> render)
+    {
+        uint32_t start = micros();
+        for (uint16_t i = 0; i < frames; i++)
+        {
+            matrix->clear();
+            render();
+        }
+        uint32_t elapsed = micros() - start;
+        JsonObject scenario = scenarios.createNestedObject();
+        scenario[F("name")] = name;
+        scenario[F("type")] = type;
+        scenario[F("us_per_frame")] = elapsed / frames;
+        scenario[F("fps")] = elapsed ? frames * 1000000.0f / elapsed : 0;
+        scenario[F("hash")] = hashBytes(2166136261, leds, sizeof(leds));
+        yield();
+    };
+
+    for (const auto &app : Apps)
+    {
+        measure(app.name, "app", [&]()
+                { app.callback(matrix, state, 0, 0, false, false, &gif, app.context); });
+    }
+    for (uint8_t i = 0; i < effectsCount; i++)
+    {
+        measure(effects[i].name, "effect", [&]()
+                { callEffect(matrix, 0, 0, i); });
+    }
+
+    // Full and patch updates of the same payload on a temporary custom app. It is added without
+    // announcing the loop and is never saved, so the benchmark doesn't publish or write to flash.
+    const char *benchmarkApp = "~benchmark";
+    const char *update = "{\"text\":\"21.5 C\",\"bar\":[3,5,2,8,6,4,7,1]}";
+    JsonArray updates = doc.createNestedArray(F("updates"));
+    auto measureUpdate = [&](const char *name, std::function<void()> apply)
+    {
+        uint32_t start = micros();
+        for (uint16_t i = 0; i < frames; i++)
+        {
+            apply();
+        }
+        uint32_t elapsed = micros() - start;
+        JsonObject scenario = updates.createNestedObject();
+        scenario[F("name")] = name;
+        scenario[F("us_per_update")] = elapsed / frames;
+        yield();
+    };
+    {
+        JsonLease lease(ARENA_PAYLOAD);
+        lease.parse(update);
+        generateCustomPage(benchmarkApp, lease.doc().as<JsonObjectConst>(), true, false);
+    }
+    measureUpdate("full", [&]()
+                  { generateCustomPage(benchmarkApp, update, true); });
+    measureUpdate("patch", [&]()
+                  { patchCustomPage(benchmarkApp, update); });
+    eraseCustomAppsByPrefix(benchmarkApp);
+    // Adding the app may have moved the pool, the UI gets entries pointing at it again
+    refreshCustomAppContexts();
+    ui->setApps(Apps, false);
+
+    appIsSwitching = wasSwitching;
+    matrix->clear();
+    ui->forceResetState();
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
+#endif
+
 String DisplayManager_::getStats()
 {
-    StaticJsonDocument<512> doc;
+    DynamicJsonDocument doc(3072);
     char buffer[20];
 #ifdef ULANZI
     doc[BatKey] = BATTERY_PERCENT;
@@ -1506,6 +1871,59 @@ String DisplayManager_::getStats()
     doc[F("indicator2")] = ui->indicator2State;
     doc[F("indicator3")] = ui->indicator3State;
     doc[F("app")] = CURRENT_APP;
+    JsonObject iconCache = doc.createNestedObject(F("icon_cache"));
+    iconCache[F("hits")] = IconCache.hits;
+    iconCache[F("misses")] = IconCache.misses;
+    iconCache[F("evictions")] = IconCache.evictions;
+    iconCache[F("icons")] = IconCache.getCount();
+    iconCache[F("bytes")] = IconCache.getUsedBytes();
+    GifCache &gifCache = GifCache::getInstance();
+    JsonObject frames = doc.createNestedObject(F("frames"));
+    frames[F("shown")] = framesShown;
+    frames[F("skipped")] = framesSkipped;
+    const FramePacing &pacing = ui->getFramePacing();
+    frames[F("rendered")] = pacing.frames;
+    frames[F("late")] = pacing.lateFrames;
+    frames[F("fps")] = pacing.fps;
+    frames[F("target_fps")] = MATRIX_FPS;
+    frames[F("jitter_us")] = pacing.jitter;
+    JsonArray histogram = frames.createNestedArray(F("histogram"));
+    for (uint8_t i = 0; i < FRAME_HISTOGRAM_BUCKETS; i++)
+        histogram.add(pacing.histogram[i]);
+    JsonObject stripStats = doc.createNestedObject(F("text_strips"));
+    stripStats[F("hits")] = TextStrips.hits;
+    stripStats[F("misses")] = TextStrips.misses;
+    stripStats[F("evictions")] = TextStrips.evictions;
+    stripStats[F("strips")] = TextStrips.getCount();
+    stripStats[F("bytes")] = TextStrips.getUsedBytes();
+    JsonObject gifStats = doc.createNestedObject(F("gif_cache"));
+    gifStats[F("hits")] = gifCache.hits;
+    gifStats[F("misses")] = gifCache.misses;
+    gifStats[F("evictions")] = gifCache.evictions;
+    gifStats[F("gifs")] = gifCache.getCount();
+    gifStats[F("bytes")] = gifCache.getUsedBytes();
+    JsonObject queueStats = doc.createNestedObject(F("notifications"));
+    queueStats[F("queued")] = notifications.size();
+    queueStats[F("capacity")] = notifications.capacity();
+    queueStats[F("high_water")] = notifications.highWater;
+    queueStats[F("received")] = notifications.pushed;
+    queueStats[F("dropped")] = notifications.dropped;
+    queueStats[F("replaced")] = notifications.replaced;
+    JsonObject arenaStats = doc.createNestedObject(F("json_arenas"));
+    arenaStats[F("size")] = JsonArena.getSize();
+    arenaStats[F("payload_used")] = JsonArena.getUsedBytes(ARENA_PAYLOAD);
+    arenaStats[F("payload_peak")] = JsonArena.getPeakBytes(ARENA_PAYLOAD);
+    arenaStats[F("fragments_used")] = JsonArena.getUsedBytes(ARENA_FRAGMENTS);
+    arenaStats[F("fragments_peak")] = JsonArena.getPeakBytes(ARENA_FRAGMENTS);
+    arenaStats[F("rejected")] = JsonArena.rejected;
+    arenaStats[F("fallbacks")] = JsonArena.fallbacks;
+    JsonObject staticStats = doc.createNestedObject(F("static_apps"));
+    staticStats[F("hits")] = staticFrameHits;
+    staticStats[F("misses")] = staticFrameMisses;
+    uint32_t staticDraws = staticFrameHits + staticFrameMisses;
+    staticStats[F("hit_ratio")] = staticDraws ? (float)staticFrameHits / staticDraws : 0;
+    staticStats[F("evictions")] = staticFrameEvictions;
+    staticStats[F("bytes")] = getStaticFrameBytes();
     String jsonString;
     return serializeJson(doc, jsonString), jsonString;
 }
@@ -1515,6 +1933,12 @@ void DisplayManager_::setAppTime(long duration)
     ui->setTimePerApp(duration);
 }
 
+// LED index of an unrotated pixel taken from the matrix_map in dev.json
+static uint16_t customLayoutXY(uint16_t x, uint16_t y)
+{
+    return MATRIX_MAP[y * MATRIX_WIDTH + x];
+}
+
 void DisplayManager_::setMatrixLayout(int layout)
 {
     delete matrix; // Free memory from the current matrix object
@@ -1534,6 +1958,14 @@ void DisplayManager_::setMatrixLayout(int layout)
         break;
     }
 
+    // The custom layout replaces the matrix layout for drawPixel itself, the canvas picks it up from there
+    if (!MATRIX_MAP.empty())
+    {
+        matrix->setRemapFunction(customLayoutXY);
+    }
+    matrix->setRotation(ROTATE_SCREEN ? 90 : 0);
+    Canvas::getInstance().begin(matrix, leds);
+    invalidateStaticFrames();
     delete ui;                        // Free memory from the current ui object
     ui = new MatrixDisplayUi(matrix); // Create a new ui object with the new matrix
 }
@@ -1544,7 +1976,7 @@ String DisplayManager_::getAppsAsJson()
     JsonObject appsObject = doc.to<JsonObject>();
     for (size_t i = 0; i < Apps.size(); i++)
     {
-        appsObject[Apps[i].first] = i;
+        appsObject[Apps[i].name] = i;
     }
     String json;
     serializeJson(appsObject, json);
@@ -1553,8 +1985,9 @@ String DisplayManager_::getAppsAsJson()
 
 void DisplayManager_::powerStateParse(const char *json)
 {
-    StaticJsonDocument<128> doc;
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
     {
         setPower((strcmp(json, "true") == 0 || strcmp(json, "1") == 0) ? true : false);
@@ -1570,7 +2003,7 @@ void DisplayManager_::powerStateParse(const char *json)
 
 void DisplayManager_::showSleepAnimation()
 {
-    matrix->setTextColor(0xFFFF);
+    setTextColor(CRGB(255, 255, 255));
     int steps[][2] = {{12, 8}, {13, 7}, {14, 6}, {15, 5}, {14, 4}, {13, 3}, {12, 2}, {13, 1}, {14, 0}, {15, -1}, {14, -2}, {13, -3}, {12, -4}, {13, -5}};
     int numSteps = sizeof(steps) / sizeof(steps[0]);
     for (int i = 0; i < numSteps; i++)
@@ -1611,7 +2044,7 @@ void DisplayManager_::setPower(bool state)
     }
 }
 
-void DisplayManager_::setIndicator1Color(uint16_t color)
+void DisplayManager_::setIndicator1Color(const CRGB &color)
 {
     ui->setIndicator1Color(color);
 }
@@ -1621,7 +2054,7 @@ void DisplayManager_::setIndicator1State(bool state)
     ui->setIndicator1State(state);
 }
 
-void DisplayManager_::setIndicator2Color(uint16_t color)
+void DisplayManager_::setIndicator2Color(const CRGB &color)
 {
     ui->setIndicator2Color(color);
 }
@@ -1631,7 +2064,7 @@ void DisplayManager_::setIndicator2State(bool state)
     ui->setIndicator2State(state);
 }
 
-void DisplayManager_::setIndicator3Color(uint16_t color)
+void DisplayManager_::setIndicator3Color(const CRGB &color)
 {
     ui->setIndicator3Color(color);
 }
@@ -1666,8 +2099,9 @@ bool DisplayManager_::indicatorParser(uint8_t indicator, const char *json)
         return true;
     }
 
-    DynamicJsonDocument doc(128);
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
         return false;
 
@@ -1675,9 +2109,9 @@ bool DisplayManager_::indicatorParser(uint8_t indicator, const char *json)
     {
         auto color = doc["color"];
 
-        uint16_t col = getColorFromJsonVariant(color, TEXTCOLOR_565);
+        CRGB col = getColorFromJsonVariant(color, TEXTCOLOR_888);
 
-        if (col > 0)
+        if (col)
         {
             switch (indicator)
             {
@@ -1754,14 +2188,28 @@ bool DisplayManager_::indicatorParser(uint8_t indicator, const char *json)
     return true;
 }
 
+// Gamma lookup table, rebuilt whenever GAMMA differs from the value it was built for
+uint8_t gammaTable[256];
+float gammaTableValue = 0;
+
 void DisplayManager_::gammaCorrection()
 {
-    if (GAMMA > 0)
+    if (GAMMA <= 0)
+        return;
+
+    if (GAMMA != gammaTableValue)
     {
         for (int i = 0; i < 256; i++)
         {
-            leds[i] = applyGamma_video(leds[i], GAMMA);
+            gammaTable[i] = applyGamma_video((uint8_t)i, GAMMA);
         }
+        gammaTableValue = GAMMA;
+    }
+
+    uint8_t *channel = (uint8_t *)leds;
+    for (int i = 0; i < MATRIX_WIDTH * MATRIX_HEIGHT * 3; i++)
+    {
+        channel[i] = gammaTable[channel[i]];
     }
 }
 
@@ -1772,12 +2220,13 @@ void DisplayManager_::sendAppLoop()
 
 String DisplayManager_::getSettings()
 {
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<768> doc;
     doc["ABRI"] = AUTO_BRIGHTNESS;
     doc["BRI"] = BRIGHTNESS;
     doc["ATRANS"] = AUTO_TRANSITION;
-    doc["TCOL"] = TEXTCOLOR_565;
+    doc["TCOL"] = rgbToHex(TEXTCOLOR_888);
     doc["TSPEED"] = TIME_PER_TRANSITION;
+    doc["TEFF"] = TRANSITION_EFFECT;
     doc["ATIME"] = TIME_PER_APP / 1000;
     doc["TFORMAT"] = TIME_FORMAT;
     doc["DFORMAT"] = DATE_FORMAT;
@@ -1791,13 +2240,13 @@ String DisplayManager_::getSettings()
     doc["CCORRECTION"] = COLOR_CORRECTION.raw;
     doc["CTEMP"] = COLOR_TEMPERATURE.raw;
     doc["WD"] = SHOW_WEEKDAY;
-    doc["WDCA"] = WDC_ACTIVE;
-    doc["WDCI"] = WDC_INACTIVE;
-    doc["TIME_COL"] = TIME_COLOR;
-    doc["DATE_COL"] = DATE_COLOR;
-    doc["HUM_COL"] = HUM_COLOR;
-    doc["TEMP_COL"] = TEMP_COLOR;
-    doc["BAT_COL"] = BAT_COLOR;
+    doc["WDCA"] = rgbToHex(WDC_ACTIVE);
+    doc["WDCI"] = rgbToHex(WDC_INACTIVE);
+    doc["TIME_COL"] = rgbToHex(TIME_COLOR);
+    doc["DATE_COL"] = rgbToHex(DATE_COLOR);
+    doc["HUM_COL"] = rgbToHex(HUM_COLOR);
+    doc["TEMP_COL"] = rgbToHex(TEMP_COLOR);
+    doc["BAT_COL"] = rgbToHex(BAT_COLOR);
     doc["SSPEED"] = SCROLL_SPEED;
     String jsonString;
     return serializeJson(doc, jsonString), jsonString;
@@ -1807,8 +2256,9 @@ void DisplayManager_::setNewSettings(const char *json)
 {
     DEBUG_PRINTLN(F("Got new settings:"));
     DEBUG_PRINTLN(json);
-    DynamicJsonDocument doc(512);
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
         return;
 
@@ -1822,6 +2272,8 @@ void DisplayManager_::setNewSettings(const char *json)
         TIME_PER_APP = TIME_PER_APP;
     }
     TIME_PER_TRANSITION = doc.containsKey("TSPEED") ? doc["TSPEED"] : TIME_PER_TRANSITION;
+    if (doc.containsKey("TEFF") && doc["TEFF"].as<uint8_t>() <= TRANSITION_WIPE)
+        TRANSITION_EFFECT = doc["TEFF"];
     BRIGHTNESS = doc.containsKey("BRI") ? doc["BRI"] : BRIGHTNESS;
     SCROLL_SPEED = doc.containsKey("SSPEED") ? doc["SSPEED"] : SCROLL_SPEED;
     IS_CELSIUS = doc.containsKey("CEL") ? doc["CEL"] : IS_CELSIUS;
@@ -1887,47 +2339,47 @@ void DisplayManager_::setNewSettings(const char *json)
     if (doc.containsKey("WDCA"))
     {
         auto WDCA = doc["WDCA"];
-        WDC_ACTIVE = getColorFromJsonVariant(WDCA, matrix->Color(255, 255, 255));
+        WDC_ACTIVE = getColorFromJsonVariant(WDCA, CRGB(255, 255, 255));
     }
     if (doc.containsKey("WDCI"))
     {
         auto WDCI = doc["WDCI"];
-        WDC_INACTIVE = getColorFromJsonVariant(WDCI, matrix->Color(120, 120, 120));
+        WDC_INACTIVE = getColorFromJsonVariant(WDCI, CRGB(120, 120, 120));
     }
     if (doc.containsKey("TCOL"))
     {
         auto TCOL = doc["TCOL"];
-        TEXTCOLOR_565 = getColorFromJsonVariant(TCOL, matrix->Color(255, 255, 255));
+        TEXTCOLOR_888 = getColorFromJsonVariant(TCOL, CRGB(255, 255, 255));
     }
     if (doc.containsKey("TIME_COL"))
     {
         auto TIME_COL = doc["TIME_COL"];
-        TIME_COLOR = getColorFromJsonVariant(TIME_COL, TEXTCOLOR_565);
+        TIME_COLOR = getColorFromJsonVariant(TIME_COL, TEXTCOLOR_888);
     }
 
     if (doc.containsKey("DATE_COL"))
     {
         auto DATE_COL = doc["DATE_COL"];
-        DATE_COLOR = getColorFromJsonVariant(DATE_COL, TEXTCOLOR_565);
+        DATE_COLOR = getColorFromJsonVariant(DATE_COL, TEXTCOLOR_888);
     }
 
     if (doc.containsKey("TEMP_COL"))
     {
         auto TEMP_COL = doc["TEMP_COL"];
-        TEMP_COLOR = getColorFromJsonVariant(TEMP_COL, TEXTCOLOR_565);
+        TEMP_COLOR = getColorFromJsonVariant(TEMP_COL, TEXTCOLOR_888);
     }
 
     if (doc.containsKey("HUM_COL"))
     {
         auto HUM_COL = doc["HUM_COL"];
-        HUM_COLOR = getColorFromJsonVariant(HUM_COL, TEXTCOLOR_565);
+        HUM_COLOR = getColorFromJsonVariant(HUM_COL, TEXTCOLOR_888);
     }
 
 #ifdef ULANZI
     if (doc.containsKey("BAT_COL"))
     {
         auto BAT_COL = doc["BAT_COL"];
-        BAT_COLOR = getColorFromJsonVariant(BAT_COL, TEXTCOLOR_565);
+        BAT_COLOR = getColorFromJsonVariant(BAT_COL, TEXTCOLOR_888);
     }
 #endif
     applyAllSettings();
@@ -1938,15 +2390,13 @@ String DisplayManager_::ledsAsJson()
 {
     StaticJsonDocument<JSON_ARRAY_SIZE(MATRIX_WIDTH * MATRIX_HEIGHT)> jsonDoc;
     JsonArray jsonColors = jsonDoc.to<JsonArray>();
+    Canvas &canvas = Canvas::getInstance();
     for (int y = 0; y < MATRIX_HEIGHT; y++)
     {
         for (int x = 0; x < MATRIX_WIDTH; x++)
         {
-            int index = matrix->XY(x, y);
-            int r = leds[index].r;
-            int g = leds[index].g;
-            int b = leds[index].b;
-            int color = (r << 16) | (g << 8) | b;
+            CRGB pixel = canvas.getPixel(x, y);
+            int color = (pixel.r << 16) | (pixel.g << 8) | pixel.b;
             jsonColors.add(color);
         }
     }
@@ -1962,12 +2412,11 @@ String DisplayManager_::getAppsWithIcon()
     for (const auto &app : Apps)
     {
         JsonObject appObject = jsonArray.createNestedObject();
-        appObject["name"] = app.first;
+        appObject["name"] = app.name;
 
-        CustomApp *customApp = getCustomAppByName(app.first);
-        if (customApp != nullptr)
+        if (app.callback == CustomAppCallback)
         {
-            appObject["icon"] = customApp->icon.name();
+            appObject["icon"] = ((CustomApp *)app.context)->icon.name();
         }
     }
     String jsonString;
@@ -1977,26 +2426,26 @@ String DisplayManager_::getAppsWithIcon()
 
 CRGB DisplayManager_::getPixelColor(int16_t x, int16_t y)
 {
-    int index = matrix->XY(x, y);
-    return leds[index];
+    return Canvas::getInstance().getPixel(x, y);
 }
 
 void DisplayManager_::reorderApps(const String &jsonString)
 {
-    StaticJsonDocument<2048> jsonDocument;
-    DeserializationError error = deserializeJson(jsonDocument, jsonString);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &jsonDocument = lease.doc();
+    DeserializationError error = lease.parse(jsonString);
     if (error)
     {
         return;
     }
 
     JsonArray jsonArray = jsonDocument.as<JsonArray>();
-    std::vector<std::pair<String, AppCallback>> reorderedApps;
+    std::vector<AppEntry> reorderedApps;
     for (const String &appName : jsonArray)
     {
         for (const auto &app : Apps)
         {
-            if (app.first == appName)
+            if (app.name == appName)
             {
                 reorderedApps.push_back(app);
                 break;
@@ -2008,122 +2457,176 @@ void DisplayManager_::reorderApps(const String &jsonString)
     ui->forceResetState();
 }
 
-void DisplayManager_::processDrawInstructions(int16_t xOffset, int16_t yOffset, String &drawInstructions)
-{
-    StaticJsonDocument<4096> doc;
-    DeserializationError error = deserializeJson(doc, drawInstructions);
-
-    if (error)
-    {
-        Serial.println("Error parsing JSON draw instructions");
-        return;
-    }
+// Opcodes of compiled draw instructions. Commands without an explicit color
+// are flagged with DRAW_DEFAULT_COLOR and use the current text color.
+enum DrawOpcode : uint16_t
+{
+    DRAW_PIXEL,
+    DRAW_LINE,
+    DRAW_RECT,
+    FILL_RECT,
+    DRAW_CIRCLE,
+    FILL_CIRCLE,
+    DRAW_TEXT,
+    DRAW_BITMAP,
+    DRAW_DEFAULT_COLOR = 0x8000
+};
+
+struct DrawCommandSpec
+{
+    const char *name;
+    uint8_t coords;
+};
+
+// Indexed by DrawOpcode
+static const DrawCommandSpec drawCommandSpecs[] = {
+    {"dp", 2},
+    {"dl", 4},
+    {"dr", 4},
+    {"df", 4},
+    {"dc", 3},
+    {"dfc", 3},
+    {"dt", 2},
+    {"db", 4}};
+
+#define MAX_DRAW_BITMAP_PIXELS 1024
+
+// Translates the "draw" array into a flat list of 16 bit words:
+// opcode, coordinates, the 24 bit color as two words (red, green << 8 | blue) and for
+// text the length followed by the packed characters, for bitmaps the raw RGB565 pixels.
+// Returns false if any instruction is malformed.
+bool DisplayManager_::compileDrawInstructions(JsonVariantConst instructions, std::vector<uint16_t> &commands)
+{
+    commands.clear();
+    if (!instructions.is<JsonArrayConst>())
+        return false;
 
-    if (!doc.is<JsonArray>())
+    for (JsonVariantConst instruction : instructions.as<JsonArrayConst>())
     {
-        Serial.println("Invalid JSON draw instructions format");
-        return;
-    }
+        if (!instruction.is<JsonObjectConst>())
+            return false;
 
-    JsonArray instructions = doc.as<JsonArray>();
-    for (JsonObject instruction : instructions)
-    {
-        for (auto kvp : instruction)
+        for (JsonPairConst kvp : instruction.as<JsonObjectConst>())
         {
-            String command = kvp.key().c_str();
+            uint16_t opcode = 0;
+            while (opcode <= DRAW_BITMAP && strcmp(drawCommandSpecs[opcode].name, kvp.key().c_str()) != 0)
+                opcode++;
+            if (opcode > DRAW_BITMAP || !kvp.value().is<JsonArrayConst>())
+                return false;
 
-            JsonArray params = kvp.value().as<JsonArray>();
-            if (command == "dp")
-            {
-                int x = params[0].as<int>();
-                int y = params[1].as<int>();
-                auto color1 = params[2];
-                uint16_t color = getColorFromJsonVariant(color1, TEXTCOLOR_565);
-                matrix->drawPixel(x + xOffset, y + yOffset, color);
-            }
-            else if (command == "dl")
-            {
-                int x0 = params[0].as<int>();
-                int y0 = params[1].as<int>();
-                int x1 = params[2].as<int>();
-                int y1 = params[3].as<int>();
-                auto color2 = params[4];
-                uint16_t color = getColorFromJsonVariant(color2, TEXTCOLOR_565);
-                matrix->drawLine(x0 + xOffset, y0 + yOffset, x1 + xOffset, y1 + yOffset, color);
-            }
-            else if (command == "dr")
-            {
-                int x = params[0].as<int>();
-                int y = params[1].as<int>();
-                int w = params[2].as<int>();
-                int h = params[3].as<int>();
-                auto color3 = params[4];
-                uint16_t color = getColorFromJsonVariant(color3, TEXTCOLOR_565);
-                matrix->drawRect(x + xOffset, y + yOffset, w, h, color);
-            }
-            else if (command == "df")
+            JsonArrayConst params = kvp.value().as<JsonArrayConst>();
+            uint8_t coordCount = drawCommandSpecs[opcode].coords;
+            size_t opcodePos = commands.size();
+            commands.push_back(opcode);
+
+            int16_t coords[4];
+            for (uint8_t i = 0; i < coordCount; i++)
             {
-                int x = params[0].as<int>();
-                int y = params[1].as<int>();
-                int w = params[2].as<int>();
-                int h = params[3].as<int>();
-                auto color4 = params[4];
-                uint16_t color = getColorFromJsonVariant(color4, TEXTCOLOR_565);
-                matrix->fillRect(x + xOffset, y + yOffset, w, h, color);
+                if (!params[i].is<float>())
+                    return false;
+                coords[i] = params[i].as<int>();
+                commands.push_back(coords[i]);
             }
-            else if (command == "dc")
+
+            if (opcode == DRAW_BITMAP)
             {
-                int x = params[0].as<int>();
-                int y = params[1].as<int>();
-                int r = params[2].as<int>();
-                auto color5 = params[3];
-                uint16_t color = getColorFromJsonVariant(color5, TEXTCOLOR_565);
-                matrix->drawCircle(x + xOffset, y + yOffset, r, color);
+                JsonArrayConst bitmap = params[4].as<JsonArrayConst>();
+                int pixels = coords[2] * coords[3];
+                if (coords[2] <= 0 || coords[3] <= 0 || pixels > MAX_DRAW_BITMAP_PIXELS || bitmap.size() != (size_t)pixels)
+                    return false;
+                for (JsonVariantConst v : bitmap)
+                    commands.push_back(v.as<uint16_t>());
+                continue;
             }
-            else if (command == "dfc")
+
+            uint8_t colorIndex = coordCount;
+            if (opcode == DRAW_TEXT)
             {
-                double x = params[0].as<double>();
-                double y = params[1].as<double>();
-                double r = params[2].as<double>();
-                auto color6 = params[3];
-                uint16_t color = getColorFromJsonVariant(color6, TEXTCOLOR_565);
-                matrix->fillCircle(x + xOffset, y + yOffset, r, color);
+                if (params[2].isNull())
+                    return false;
+                colorIndex = 3;
             }
-            else if (command == "dt")
+
+            JsonVariantConst color = params[colorIndex];
+            if (color.isNull())
+                commands[opcodePos] |= DRAW_DEFAULT_COLOR;
+            CRGB rgb = getColorFromJsonVariant(color, TEXTCOLOR_888);
+            commands.push_back(rgb.r);
+            commands.push_back((rgb.g << 8) | rgb.b);
+
+            if (opcode == DRAW_TEXT)
             {
-                int x = params[0].as<int>();
-                int y = params[1].as<int>();
-                String text = params[2].as<String>();
-                auto color7 = params[3];
-                uint16_t color = getColorFromJsonVariant(color7, TEXTCOLOR_565);
-                matrix->setCursor(x + xOffset, y + yOffset + 5);
-                matrix->setTextColor(color);
-                matrix->print(utf8ascii(text));
+                String text = utf8ascii(params[2].as<String>());
+                commands.push_back(text.length());
+                for (size_t i = 0; i < text.length(); i += 2)
+                {
+                    uint8_t hi = i + 1 < text.length() ? text[i + 1] : 0;
+                    commands.push_back((hi << 8) | (uint8_t)text[i]);
+                }
             }
-            else if (command == "db")
-            {
-                int x = params[0].as<int>();
-                int y = params[1].as<int>();
-                int w = params[2].as<int>();
-                int h = params[3].as<int>();
+        }
+    }
+    commands.shrink_to_fit();
+    return true;
+}
 
-                // Create an array to hold the color data
-                uint16_t bitmap[w * h];
+void DisplayManager_::processDrawInstructions(int16_t xOffset, int16_t yOffset, const std::vector<uint16_t> &commands)
+{
+    const uint16_t *pc = commands.data();
+    const uint16_t *end = pc + commands.size();
+    int16_t c[4];
+    Canvas &canvas = Canvas::getInstance();
 
-                // Assume that params[4] is a JsonArray
-                JsonArray colorArray = params[4].as<JsonArray>();
+    while (pc < end)
+    {
+        uint16_t opcode = *pc++;
+        uint16_t op = opcode & ~DRAW_DEFAULT_COLOR;
+        uint8_t coordCount = drawCommandSpecs[op].coords;
+        for (uint8_t i = 0; i < coordCount; i++)
+            c[i] = *pc++;
 
-                // Load the color data into the array
-                int i = 0;
-                for (JsonVariant v : colorArray)
-                {
-                    bitmap[i] = v.as<uint16_t>();
-                    i++;
-                }
+        if (op == DRAW_BITMAP)
+        {
+            canvas.blit(c[0] + xOffset, c[1] + yOffset, pc, c[2], c[3]);
+            pc += c[2] * c[3];
+            continue;
+        }
 
-                // Draw the bitmap
-                matrix->drawRGBBitmap(x + xOffset, y + yOffset, bitmap, w, h);
-            }
+        CRGB color(pc[0], pc[1] >> 8, pc[1] & 0xFF);
+        pc += 2;
+        if (opcode & DRAW_DEFAULT_COLOR)
+            color = TEXTCOLOR_888;
+        // Only used by the Adafruit_GFX primitives below, which ignore their own color argument
+        TrueColor gfxColor(matrix, color);
+
+        switch (op)
+        {
+        case DRAW_PIXEL:
+            canvas.setPixel(c[0] + xOffset, c[1] + yOffset, color);
+            break;
+        case DRAW_LINE:
+            matrix->drawLine(c[0] + xOffset, c[1] + yOffset, c[2] + xOffset, c[3] + yOffset, 0);
+            break;
+        case DRAW_RECT:
+            matrix->drawRect(c[0] + xOffset, c[1] + yOffset, c[2], c[3], 0);
+            break;
+        case FILL_RECT:
+            canvas.fillRect(c[0] + xOffset, c[1] + yOffset, c[2], c[3], color);
+            break;
+        case DRAW_CIRCLE:
+            matrix->drawCircle(c[0] + xOffset, c[1] + yOffset, c[2], 0);
+            break;
+        case FILL_CIRCLE:
+            matrix->fillCircle(c[0] + xOffset, c[1] + yOffset, c[2], 0);
+            break;
+        case DRAW_TEXT:
+        {
+            uint16_t length = *pc++;
+            matrix->setCursor(c[0] + xOffset, c[1] + yOffset + 5);
+            matrix->write((const uint8_t *)pc, length);
+            pc += (length + 1) / 2;
+            break;
+        }
         }
     }
 }
@@ -2136,8 +2639,9 @@ bool DisplayManager_::moodlight(const char *json)
         return true;
     }
 
-    DynamicJsonDocument doc(512);
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
         return false;
 
@@ -2158,8 +2662,8 @@ bool DisplayManager_::moodlight(const char *json)
     else if (doc.containsKey("color"))
     {
         auto c = doc["color"];
-        uint16_t color565 = getColorFromJsonVariant(c, TEXTCOLOR_565);
-        matrix->fillScreen(color565);
+        CRGB color = getColorFromJsonVariant(c, TEXTCOLOR_888);
+        Canvas::getInstance().fillRect(0, 0, MATRIX_WIDTH, MATRIX_HEIGHT, color);
     }
     else
     {
@@ -2168,23 +2672,19 @@ bool DisplayManager_::moodlight(const char *json)
 
     MOODLIGHT_MODE = true;
 
-    matrix->show();
+    show();
     return true;
 }
 
 int *DisplayManager_::getLedColors()
 {
-    int *ledColors = new int[MATRIX_WIDTH * MATRIX_HEIGHT];
-    for (int y = 0; y < MATRIX_HEIGHT; y++)
+    int *ledColors = new int[MATRIX_WIDTH * MATRIX_HEIGHT]();
+    Canvas &canvas = Canvas::getInstance();
+    for (uint16_t led = 0; led < MATRIX_WIDTH * MATRIX_HEIGHT; led++)
     {
-        for (int x = 0; x < MATRIX_WIDTH; x++)
-        {
-            int index = matrix->XY(x, y);
-            int r = leds[index].r;
-            int g = leds[index].g;
-            int b = leds[index].b;
-            ledColors[y * MATRIX_WIDTH + x] = (r << 16) | (g << 8) | b;
-        }
+        uint16_t pixel = canvas.pixelIndex(led);
+        if (pixel != CANVAS_UNMAPPED)
+            ledColors[pixel] = (leds[led].r << 16) | (leds[led].g << 8) | leds[led].b;
     }
     return ledColors;
 }
@@ -2207,14 +2707,15 @@ void DisplayManager_::sendBMP(Stream &stream)
     char *img = (char *)malloc(3 * scaledW * scaledH);
     memset(img, 0, 3 * scaledW * scaledH); // initialize all pixels to black
 
+    Canvas &canvas = Canvas::getInstance();
     for (int y = 0; y < h; y++)
     {
         for (int x = 0; x < w; x++)
         {
-            int index = matrix->XY(x, y);
-            int r = leds[index].r;
-            int g = leds[index].g;
-            int b = leds[index].b;
+            CRGB pixel = canvas.getPixel(x, y);
+            int r = pixel.r;
+            int g = pixel.g;
+            int b = pixel.b;
 
             // Write the same color to the corresponding cells in the scaled image
             for (int i = 0; i < scaleFactor; i++)
@@ -6,6 +6,7 @@
 #include <LittleFS.h>
 #include <vector>
 #include <FastLED_NeoMatrix.h>
+#include "TextStripCache.h"
 
 class DisplayManager_
 {
@@ -36,10 +37,15 @@ struct RGB {
     static DisplayManager_ &getInstance();
     bool appIsSwitching;
     bool showGif;
+    uint32_t framesShown = 0;
+    uint32_t framesSkipped = 0;
     void setup();
     void tick();
     void clear();
     void show();
+    void showFrame();
+    void startBootAnimation();
+    void stopBootAnimation();
     void applyAllSettings();
     void rightButton();
     void dismissNotify();
@@ -55,40 +61,49 @@ struct RGB {
     void selectButton();
     void selectButtonLong();
     void setBrightness(int);
-    void setTextColor(uint16_t color);
+    void setTextColor(const CRGB &color);
     bool generateNotification(uint8_t source,const char *json);
     bool generateCustomPage(const String &name, const char *json, bool preventSave);
+    bool generateCustomPage(const String &name, JsonObjectConst doc, bool preventSave, bool setApps);
+    bool patchCustomPage(const String &name, const char *json);
     void printText(int16_t x, int16_t y, const char *text, bool centered, byte textCase);
+    TextStrip *renderTextStrip(uint32_t key, const String &text, const std::vector<TextSegment> &segments, uint16_t width, byte textCase);
+    void drawTextStrip(int16_t x, int16_t y, const TextStrip &strip);
     bool setAutoTransition(bool active);
     bool switchToApp(const char *json);
     void setNewSettings(const char *json);
     void drawJPG(uint16_t x, uint16_t y, fs::File jpgFile);
-    void drawProgressBar(int16_t x, int16_t y, int progress, uint16_t pColor, uint16_t pbColor);
+    void drawProgressBar(int16_t x, int16_t y, int progress, const CRGB &pColor, const CRGB &pbColor);
     void drawMenuIndicator(int cur, int total, uint16_t color);
     void drawBMP(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h);
-    void drawBarChart(int16_t x, int16_t y, const int data[], byte dataSize, bool withIcon, uint16_t color);
-    void drawLineChart(int16_t x, int16_t y, const int data[], byte dataSize, bool withIcon, uint16_t color);
+    void drawBarChart(int16_t x, int16_t y, const int data[], byte dataSize, bool withIcon, const CRGB &color);
+    void drawLineChart(int16_t x, int16_t y, const int data[], byte dataSize, bool withIcon, const CRGB &color);
     void updateAppVector(const char *json);
     void setMatrixLayout(int layout);
     void setAppTime(long duration);
     String getAppsAsJson();
     String getStats();
+#ifdef PERF_PROFILING
+    String runBenchmark(uint16_t frames);
+#endif
     String getSettings();
     void setPower(bool state);
     void powerStateParse(const char *json);
-    void setIndicator1Color(uint16_t color);
+    void setIndicator1Color(const CRGB &color);
     void setIndicator1State(bool state);
-    void setIndicator2Color(uint16_t color);
+    void setIndicator2Color(const CRGB &color);
     void setIndicator2State(bool state);
-    void setIndicator3Color(uint16_t color);
+    void setIndicator3Color(const CRGB &color);
     void setIndicator3State(bool state);
     void reorderApps(const String &jsonString);
     void gammaCorrection();
+    void invalidateStaticFrames();
     bool indicatorParser(uint8_t indicator, const char *json);
     void showSleepAnimation();
     void showCurtainEffect();
     void sendAppLoop();
-    void processDrawInstructions(int16_t x, int16_t y, String &drawInstructions);
+    bool compileDrawInstructions(JsonVariantConst instructions, std::vector<uint16_t> &commands);
+    void processDrawInstructions(int16_t x, int16_t y, const std::vector<uint16_t> &commands);
     String ledsAsJson();
     String getAppsWithIcon();
     void startArtnet();
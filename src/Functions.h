@@ -1,12 +1,62 @@
 #ifndef FUNCTIONS_H
 #define FUNCTIONS_H
 
-#include <map>
 #include <FastLED_NeoMatrix.h>
 #include <Globals.h>
 
-std::map<char, uint16_t> CharMap = {
-    {32, 2}, {33, 2}, {34, 4}, {35, 4}, {36, 4}, {37, 4}, {38, 4}, {39, 2}, {40, 3}, {41, 3}, {42, 4}, {43, 4}, {44, 3}, {45, 4}, {46, 2}, {47, 4}, {48, 4}, {49, 4}, {50, 4}, {51, 4}, {52, 4}, {53, 4}, {54, 4}, {55, 4}, {56, 4}, {57, 4}, {58, 2}, {59, 3}, {60, 4}, {61, 4}, {62, 4}, {63, 4}, {64, 4}, {65, 4}, {66, 4}, {67, 4}, {68, 4}, {69, 4}, {70, 4}, {71, 4}, {72, 4}, {73, 2}, {74, 4}, {75, 4}, {76, 4}, {77, 6}, {78, 5}, {79, 4}, {80, 4}, {81, 5}, {82, 4}, {83, 4}, {84, 4}, {85, 4}, {86, 4}, {87, 6}, {88, 4}, {89, 4}, {90, 4}, {91, 4}, {92, 4}, {93, 4}, {94, 4}, {95, 4}, {96, 3}, {97, 4}, {98, 4}, {99, 4}, {100, 4}, {101, 4}, {102, 4}, {103, 4}, {104, 4}, {105, 2}, {106, 4}, {107, 4}, {108, 4}, {109, 4}, {110, 4}, {111, 4}, {112, 4}, {113, 4}, {114, 4}, {115, 4}, {116, 4}, {117, 4}, {118, 4}, {119, 4}, {120, 4}, {121, 4}, {122, 4}, {123, 4}, {124, 2}, {125, 4}, {126, 4}, {161, 2}, {162, 4}, {163, 4}, {164, 4}, {165, 4}, {166, 2}, {167, 4}, {168, 4}, {169, 4}, {170, 4}, {171, 3}, {172, 4}, {173, 3}, {174, 4}, {175, 4}, {176, 3}, {177, 4}, {178, 4}, {179, 4}, {180, 3}, {181, 4}, {182, 4}, {183, 4}, {184, 4}, {185, 2}, {186, 4}, {187, 3}, {188, 4}, {189, 4}, {190, 4}, {191, 4}, {192, 4}, {193, 4}, {194, 4}, {195, 4}, {196, 4}, {197, 4}, {198, 4}, {199, 4}, {200, 4}, {201, 4}, {202, 4}, {203, 4}, {204, 4}, {205, 4}, {206, 4}, {207, 4}, {208, 4}, {209, 4}, {210, 4}, {211, 4}, {212, 4}, {213, 4}, {214, 4}, {215, 4}, {216, 4}, {217, 4}, {218, 4}, {219, 4}, {220, 4}, {221, 4}, {222, 4}, {223, 4}, {224, 4}, {225, 4}, {226, 4}, {227, 4}, {228, 4}, {229, 4}, {230, 4}, {231, 4}, {232, 4}, {233, 4}, {234, 4}, {235, 4}, {236, 3}, {237, 3}, {238, 4}, {239, 4}, {240, 4}, {241, 4}, {242, 4}, {243, 4}, {244, 4}, {245, 4}, {246, 4}, {247, 4}, {248, 4}, {249, 4}, {250, 4}, {251, 4}, {252, 4}, {253, 4}, {254, 4}, {255, 4}, {285, 2}, {338, 4}, {339, 4}, {352, 4}, {353, 4}, {376, 4}, {381, 4}, {382, 4}, {3748, 2}, {5024, 2}, {8226, 2}, {8230, 4}, {8364, 4}, {65533, 4}};
+#include "Fonts/AwtrixFont.h"
+
+// Cursor advance of a (utf8ascii transcoded) byte as rendered with AwtrixFont.
+// Bytes without a glyph count as 4 pixels.
+constexpr uint8_t glyphAdvance(uint8_t c)
+{
+    return (c < 0x20 || (unsigned)(c - 0x20) >= sizeof(AwtrixFontGlyphs) / sizeof(GFXglyph)) ? 4 : AwtrixFontGlyphs[c - 0x20].xAdvance;
+}
+
+constexpr uint8_t upperGlyphAdvance(uint8_t c)
+{
+    return glyphAdvance((c >= 'a' && c <= 'z') ? c - 32 : c);
+}
+
+#define GLYPH_ADVANCE_ROW(f, r) \
+    f(r + 0), f(r + 1), f(r + 2), f(r + 3), f(r + 4), f(r + 5), f(r + 6), f(r + 7), \
+    f(r + 8), f(r + 9), f(r + 10), f(r + 11), f(r + 12), f(r + 13), f(r + 14), f(r + 15)
+
+constexpr uint8_t GlyphAdvance[256] = {
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x00),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x10),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x20),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x30),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x40),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x50),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x60),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x70),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x80),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0x90),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0xA0),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0xB0),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0xC0),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0xD0),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0xE0),
+    GLYPH_ADVANCE_ROW(glyphAdvance, 0xF0)};
+
+constexpr uint8_t UpperGlyphAdvance[256] = {
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x00),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x10),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x20),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x30),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x40),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x50),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x60),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x70),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x80),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0x90),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0xA0),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0xB0),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0xC0),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0xD0),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0xE0),
+    GLYPH_ADVANCE_ROW(upperGlyphAdvance, 0xF0)};
 
 //---------------------------------------------------------------
 // This is the gamma lookup for mapping 255 brightness levels
@@ -70,80 +120,81 @@ CRGB applyGammaCorrection(const CRGB& color) {
   return correctedColor;
 }
 
-uint32_t hsvToRgb(uint8_t h, uint8_t s, uint8_t v)
+CRGB hsvToRgb(uint8_t h, uint8_t s, uint8_t v)
 {
-    CHSV hsv(h, s, v);
     CRGB rgb;
-    hsv2rgb_spectrum(hsv, rgb);
-    return ((uint16_t)(rgb.r & 0xF8) << 8) |
-           ((uint16_t)(rgb.g & 0xFC) << 3) |
-           (rgb.b >> 3);
+    hsv2rgb_spectrum(CHSV(h, s, v), rgb);
+    return rgb;
 }
 
-uint16_t hexToRgb565(String hexValue, uint16_t defaultColor)
+CRGB hexToRgb(String hexValue, const CRGB &defaultColor)
 {
     hexValue.replace("#", "");
-    uint8_t r = strtol(hexValue.substring(0, 2).c_str(), NULL, 16);
-    uint8_t g = strtol(hexValue.substring(2, 4).c_str(), NULL, 16);
-    uint8_t b = strtol(hexValue.substring(4, 6).c_str(), NULL, 16);
-    if ((errno == ERANGE) || (r > 255) || (g > 255) || (b > 255))
+    if (hexValue.length() != 6)
+    {
+        return defaultColor;
+    }
+    char *end;
+    uint32_t color = strtoul(hexValue.c_str(), &end, 16);
+    if (*end != '\0')
     {
         return defaultColor;
     }
-    uint16_t color = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
-    return color;
+    return CRGB(color);
 }
 
+String rgbToHex(const CRGB &color)
+{
+    char hex[8];
+    snprintf(hex, sizeof(hex), "#%02X%02X%02X", color.r, color.g, color.b);
+    return String(hex);
+}
 
-uint16_t getColorFromJsonVariant(JsonVariant colorVariant, uint16_t defaultColor)
+CRGB getColorFromJsonVariant(JsonVariantConst colorVariant, const CRGB &defaultColor)
 {
     if (colorVariant.is<String>())
     {
-        return hexToRgb565(colorVariant.as<String>(), defaultColor);
+        return hexToRgb(colorVariant.as<String>(), defaultColor);
     }
-    else if (colorVariant.is<JsonArray>())
+    else if (colorVariant.is<JsonArrayConst>())
     {
-        JsonArray colorArray = colorVariant.as<JsonArray>();
+        JsonArrayConst colorArray = colorVariant.as<JsonArrayConst>();
         if (colorArray.size() == 3) // RGB
         {
             uint8_t r = colorArray[0];
             uint8_t g = colorArray[1];
             uint8_t b = colorArray[2];
-            return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+            return CRGB(r, g, b);
         }
         else if (colorArray.size() == 4 && colorArray[0] == "HSV") // HSV
         {
             uint8_t h = colorArray[1];
             uint8_t s = colorArray[2];
             uint8_t v = colorArray[3];
-            CRGB rgb;
-            hsv2rgb_spectrum(CHSV(h, s, v), rgb);
-            return (rgb.red << 11) | (rgb.green << 5) | rgb.blue;
+            return hsvToRgb(h, s, v);
         }
     }
+    else if (colorVariant.is<uint16_t>()) // RGB565
+    {
+        return rgb565ToRgb(colorVariant.as<uint16_t>());
+    }
 
     return defaultColor;
 }
 
 
+const uint8_t *getGlyphAdvances(byte textCase)
+{
+    return ((UPPERCASE_LETTERS && textCase == 0) || textCase == 1) ? UpperGlyphAdvance : GlyphAdvance;
+}
+
 float getTextWidth(const char *text, byte textCase)
 {
-    float width = 0;
-    for (const char *c = text; *c != '\0'; ++c)
+    const uint8_t *advances = getGlyphAdvances(textCase);
+    uint16_t width = 0;
+    for (const uint8_t *c = (const uint8_t *)text; *c != '\0'; ++c)
     {
-        char current_char = *c;
-        if ((UPPERCASE_LETTERS && textCase == 0) || textCase == 1)
-        {
-            current_char = toupper(current_char);
-        }
-        if (CharMap.count(current_char) > 0)
-        {
-            width += CharMap[current_char];
-        }
-        else
-        {
-            width += 4;
-        }
+        width += advances[*c];
     }
     return width;
 }
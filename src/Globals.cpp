@@ -42,7 +42,7 @@ void loadDevSettings()
     if (LittleFS.exists("/dev.json"))
     {
         File file = LittleFS.open("/dev.json", "r");
-        DynamicJsonDocument doc(1024);
+        DynamicJsonDocument doc(6144);
         DeserializationError error = deserializeJson(doc, file);
         if (error)
         {
@@ -67,6 +67,23 @@ void loadDevSettings()
             MATRIX_LAYOUT = doc["matrix"];
         }
 
+        if (doc.containsKey("matrix_map"))
+        {
+            JsonArray map = doc["matrix_map"];
+            MATRIX_MAP.clear();
+            for (uint16_t index : map)
+            {
+                if (index >= 256)
+                    break;
+                MATRIX_MAP.push_back(index);
+            }
+            if (MATRIX_MAP.size() != 256)
+            {
+                DEBUG_PRINTLN(F("matrix_map needs 256 LED indices below 256, ignoring it"));
+                MATRIX_MAP.clear();
+            }
+        }
+
         if (doc.containsKey("temp_offset"))
         {
             TEMP_OFFSET = doc["temp_offset"];
@@ -118,6 +135,41 @@ void loadDevSettings()
             ROTATE_SCREEN = doc["rotate_screen"].as<bool>();
         }
 
+        if (doc.containsKey("icon_cache_size"))
+        {
+            ICON_CACHE_SIZE = doc["icon_cache_size"].as<uint32_t>();
+        }
+
+        if (doc.containsKey("text_strip_size"))
+        {
+            TEXT_STRIP_SIZE = doc["text_strip_size"].as<uint32_t>();
+        }
+
+        if (doc.containsKey("static_frame_size"))
+        {
+            STATIC_FRAME_SIZE = doc["static_frame_size"].as<uint32_t>();
+        }
+
+        if (doc.containsKey("gif_cache_size"))
+        {
+            GIF_CACHE_SIZE = doc["gif_cache_size"].as<uint32_t>();
+        }
+
+        if (doc.containsKey("json_arena_size"))
+        {
+            JSON_ARENA_SIZE = max(doc["json_arena_size"].as<uint32_t>(), (uint32_t)512);
+        }
+
+        if (doc.containsKey("notification_queue_size"))
+        {
+            NOTIFICATION_QUEUE_SIZE = max(doc["notification_queue_size"].as<uint8_t>(), (uint8_t)1);
+        }
+
+        if (doc.containsKey("notification_overflow"))
+        {
+            NOTIFICATION_OVERFLOW = doc["notification_overflow"].as<String>() == "drop_new" ? 1 : 0;
+        }
+
         if (doc.containsKey("gamma"))
         {
             GAMMA = doc["gamma"].as<float>();
@@ -155,6 +207,31 @@ void loadDevSettings()
     }
 }
 
+// Colors are stored as 24 bit values flagged with bit 24, settings from older
+// firmware without the flag are RGB565
+#define COLOR_SETTING_RGB888 0x1000000
+
+CRGB rgb565ToRgb(uint16_t color)
+{
+    uint8_t r = (color >> 11) & 0x1F;
+    uint8_t g = (color >> 5) & 0x3F;
+    uint8_t b = color & 0x1F;
+    return CRGB((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+CRGB loadColor(const char *key, uint16_t defaultColor)
+{
+    uint32_t value = Settings.getUInt(key, defaultColor);
+    if (value & COLOR_SETTING_RGB888)
+        return CRGB(value & 0xFFFFFF);
+    return rgb565ToRgb(value);
+}
+
+void saveColor(const char *key, const CRGB &color)
+{
+    Settings.putUInt(key, COLOR_SETTING_RGB888 | ((uint32_t)color.r << 16) | (color.g << 8) | color.b);
+}
+
 void loadSettings()
 {
     startLittleFS();
@@ -162,20 +239,21 @@ void loadSettings()
     Settings.begin("awtrix", false);
     BRIGHTNESS = Settings.getUInt("BRI", 120);
     AUTO_BRIGHTNESS = Settings.getBool("ABRI", false);
-    TEXTCOLOR_565 = Settings.getUInt("TCOL", 0xFFFF);
+    TEXTCOLOR_888 = loadColor("TCOL", 0xFFFF);
 
-    TIME_COLOR = Settings.getUInt("TIME_COL", 0);
-    DATE_COLOR = Settings.getUInt("DATE_COL", 0);
-    TEMP_COLOR = Settings.getUInt("TEMP_COL", 0);
-    HUM_COLOR = Settings.getUInt("HUM_COL", 0);
+    TIME_COLOR = loadColor("TIME_COL", 0);
+    DATE_COLOR = loadColor("DATE_COL", 0);
+    TEMP_COLOR = loadColor("TEMP_COL", 0);
+    HUM_COLOR = loadColor("HUM_COL", 0);
 #ifdef ULANZI
-    BAT_COLOR = Settings.getUInt("BAT_COL", 0);
+    BAT_COLOR = loadColor("BAT_COL", 0);
 #endif
-    WDC_ACTIVE = Settings.getUInt("WDCA", 0xFFFF);
-    WDC_INACTIVE = Settings.getUInt("WDCI", 0x6B6D);
+    WDC_ACTIVE = loadColor("WDCA", 0xFFFF);
+    WDC_INACTIVE = loadColor("WDCI", 0x6B6D);
     AUTO_TRANSITION = Settings.getBool("ATRANS", true);
     SHOW_WEEKDAY = Settings.getBool("WD", true);
     TIME_PER_TRANSITION = Settings.getUInt("TSPEED", 400);
+    TRANSITION_EFFECT = Settings.getUInt("TEFF", 0);
     TIME_PER_APP = Settings.getUInt("ATIME", 7000);
     TIME_FORMAT = Settings.getString("TFORMAT", "%H:%M:%S");
     DATE_FORMAT = Settings.getString("DFORMAT", "%d.%m.%y");
@@ -209,17 +287,18 @@ void saveSettings()
     Settings.putBool("WD", SHOW_WEEKDAY);
     Settings.putBool("ABRI", AUTO_BRIGHTNESS);
     Settings.putBool("ATRANS", AUTO_TRANSITION);
-    Settings.putUInt("TCOL", TEXTCOLOR_565);
-    Settings.putUInt("TIME_COL", TIME_COLOR);
-    Settings.putUInt("DATE_COL", DATE_COLOR);
-    Settings.putUInt("TEMP_COL", TEMP_COLOR);
-    Settings.putUInt("HUM_COL", HUM_COLOR);
+    saveColor("TCOL", TEXTCOLOR_888);
+    saveColor("TIME_COL", TIME_COLOR);
+    saveColor("DATE_COL", DATE_COLOR);
+    saveColor("TEMP_COL", TEMP_COLOR);
+    saveColor("HUM_COL", HUM_COLOR);
 #ifdef ULANZI
-    Settings.putUInt("BAT_COL", BAT_COLOR);
+    saveColor("BAT_COL", BAT_COLOR);
 #endif
-    Settings.putUInt("WDCA", WDC_ACTIVE);
-    Settings.putUInt("WDCI", WDC_INACTIVE);
+    saveColor("WDCA", WDC_ACTIVE);
+    saveColor("WDCI", WDC_INACTIVE);
     Settings.putUInt("TSPEED", TIME_PER_TRANSITION);
+    Settings.putUInt("TEFF", TRANSITION_EFFECT);
     Settings.putUInt("ATIME", TIME_PER_APP);
     Settings.putString("TFORMAT", TIME_FORMAT);
     Settings.putString("DFORMAT", DATE_FORMAT);
@@ -274,6 +353,7 @@ String NET_SDNS = "1.1.1.1";
 long TIME_PER_APP = 7000;
 uint8_t MATRIX_FPS = 50;
 int TIME_PER_TRANSITION = 400;
+uint8_t TRANSITION_EFFECT = 0;
 String NTP_SERVER = "de.pool.ntp.org";
 String NTP_TZ = "CET-1CEST,M3.5.0,M10.5.0/3";
 bool HA_DISCOVERY = false;
@@ -318,7 +398,7 @@ bool AP_MODE;
 bool MATRIX_OFF;
 bool TIMER_ACTIVE;
 bool ALARM_ACTIVE;
-uint16_t TEXTCOLOR_565;
+CRGB TEXTCOLOR_888;
 bool SOUND_ACTIVE;
 String BOOT_SOUND = "";
 int TEMP_DECIMAL_PLACES = 0;
@@ -331,21 +411,29 @@ bool UPDATE_AVAILABLE = false;
 long RECEIVED_MESSAGES;
 CRGB COLOR_CORRECTION;
 CRGB COLOR_TEMPERATURE;
-uint16_t WDC_ACTIVE;
-uint16_t WDC_INACTIVE;
+std::vector<uint16_t> MATRIX_MAP;
+CRGB WDC_ACTIVE;
+CRGB WDC_INACTIVE;
 bool BLOCK_NAVIGATION = false;
 bool UPDATE_CHECK = false;
 float GAMMA = 0;
 bool SENSOR_READING = true;
 bool ROTATE_SCREEN = false;
 uint8_t SCROLL_SPEED = 100;
-uint16_t TIME_COLOR = 0;
-uint16_t DATE_COLOR = 0;
-uint16_t BAT_COLOR = 0;
-uint16_t TEMP_COLOR = 0;
-uint16_t HUM_COLOR = 0;
+CRGB TIME_COLOR;
+CRGB DATE_COLOR;
+CRGB BAT_COLOR;
+CRGB TEMP_COLOR;
+CRGB HUM_COLOR;
 bool ARTNET_MODE;
 bool MOODLIGHT_MODE;
 uint8_t MIN_BRIGHTNESS = 2;
 uint8_t MAX_BRIGHTNESS = 180;
+uint32_t ICON_CACHE_SIZE = 8192;
+uint32_t GIF_CACHE_SIZE = 16384;
+uint32_t TEXT_STRIP_SIZE = 8192;
+uint32_t STATIC_FRAME_SIZE = 8192;
+uint32_t JSON_ARENA_SIZE = 4096;
+uint8_t NOTIFICATION_QUEUE_SIZE = 10;
+uint8_t NOTIFICATION_OVERFLOW = 0;
 float movementFactor = 0.5;
\ No newline at end of file
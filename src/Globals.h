@@ -2,6 +2,7 @@
 #define GLOBALS_H
 #include <Arduino.h>
 #include <FastLED.h>
+#include <vector>
 
 #define DEBUG
 
@@ -61,6 +62,7 @@ extern String NET_SDNS;
 extern long TIME_PER_APP;
 extern uint8_t MATRIX_FPS;
 extern int TIME_PER_TRANSITION;
+extern uint8_t TRANSITION_EFFECT;
 extern String NTP_SERVER;
 extern String NTP_TZ;
 extern bool HA_DISCOVERY;
@@ -88,7 +90,7 @@ extern bool TIMER_ACTIVE;
 extern bool MATRIX_OFF;
 extern String ALARM_SOUND;
 extern String TIMER_SOUND;
-extern uint16_t TEXTCOLOR_565;
+extern CRGB TEXTCOLOR_888;
 extern uint8_t SNOOZE_TIME;
 extern bool AUTO_TRANSITION;
 extern String TIME_FORMAT;
@@ -110,13 +112,16 @@ extern uint8_t VOLUME_PERCENT;
 extern uint8_t VOLUME;
 #endif
 extern int MATRIX_LAYOUT;
+extern std::vector<uint16_t> MATRIX_MAP;
 extern bool UPDATE_AVAILABLE;
 extern long RECEIVED_MESSAGES;
 extern CRGB COLOR_CORRECTION;
 extern CRGB COLOR_TEMPERATURE;
-extern uint16_t WDC_ACTIVE;
-extern uint16_t WDC_INACTIVE;
+extern CRGB WDC_ACTIVE;
+extern CRGB WDC_INACTIVE;
 extern float GAMMA;
+// RGB565 is only accepted as input from older clients and settings, colors are kept as 24 bit CRGB
+CRGB rgb565ToRgb(uint16_t color);
 void loadSettings();
 void saveSettings();
 extern bool BLOCK_NAVIGATION;
@@ -124,14 +129,21 @@ extern bool UPDATE_CHECK;
 extern bool SENSOR_READING;
 extern bool ROTATE_SCREEN;
 extern uint8_t SCROLL_SPEED;
-extern uint16_t TIME_COLOR;
-extern uint16_t DATE_COLOR;
-extern uint16_t BAT_COLOR;
-extern uint16_t TEMP_COLOR;
-extern uint16_t HUM_COLOR;
+extern CRGB TIME_COLOR;
+extern CRGB DATE_COLOR;
+extern CRGB BAT_COLOR;
+extern CRGB TEMP_COLOR;
+extern CRGB HUM_COLOR;
 extern bool ARTNET_MODE;
 extern bool MOODLIGHT_MODE;
 extern float movementFactor;
 extern uint8_t MIN_BRIGHTNESS;
 extern uint8_t MAX_BRIGHTNESS;
+extern uint32_t ICON_CACHE_SIZE;
+extern uint32_t GIF_CACHE_SIZE;
+extern uint32_t TEXT_STRIP_SIZE;
+extern uint32_t STATIC_FRAME_SIZE;
+extern uint32_t JSON_ARENA_SIZE;
+extern uint8_t NOTIFICATION_QUEUE_SIZE;
+extern uint8_t NOTIFICATION_OVERFLOW;
 #endif // Globals_H
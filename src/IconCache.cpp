@@ -0,0 +1,156 @@
+#include "IconCache.h"
+#include <TJpg_Decoder.h>
+#include "Globals.h"
+
+#define CAPTURE_WIDTH 32
+#define CAPTURE_HEIGHT 8
+
+static uint16_t captureBuffer[CAPTURE_WIDTH * CAPTURE_HEIGHT];
+static uint8_t captureWidth;
+static uint8_t captureHeight;
+
+// TJpgDec output callback used while decoding into the cache instead of the matrix
+static bool captureOutput(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap)
+{
+    uint16_t bitmapIndex = 0;
+    for (uint16_t row = 0; row < h; row++)
+    {
+        for (uint16_t col = 0; col < w; col++)
+        {
+            int16_t px = x + col;
+            int16_t py = y + row;
+            uint16_t color = bitmap[bitmapIndex++];
+            if (px < 0 || py < 0 || px >= CAPTURE_WIDTH || py >= CAPTURE_HEIGHT)
+                continue;
+            captureBuffer[py * CAPTURE_WIDTH + px] = color;
+            if (px + 1 > captureWidth)
+                captureWidth = px + 1;
+            if (py + 1 > captureHeight)
+                captureHeight = py + 1;
+        }
+    }
+    return 1;
+}
+
+// The getter for the instantiated singleton instance
+IconCache_ &IconCache_::getInstance()
+{
+    static IconCache_ instance;
+    return instance;
+}
+
+// Initialize the global shared instance
+IconCache_ &IconCache = IconCache.getInstance();
+
+void IconCache_::setBudget(size_t bytes)
+{
+    budget = bytes;
+    evict(0);
+}
+
+bool IconCache_::decode(fs::File &file, Entry &entry)
+{
+    captureWidth = 0;
+    captureHeight = 0;
+    SketchCallback previousOutput = TJpgDec.tft_output;
+    TJpgDec.setCallback(captureOutput);
+    JRESULT result = TJpgDec.drawFsJpg(0, 0, file);
+    TJpgDec.setCallback(previousOutput);
+
+    if (result != JDR_OK || captureWidth == 0 || captureHeight == 0)
+        return false;
+
+    entry.width = captureWidth;
+    entry.height = captureHeight;
+    entry.pixels = new uint16_t[captureWidth * captureHeight];
+    for (uint8_t y = 0; y < captureHeight; y++)
+    {
+        memcpy(entry.pixels + y * captureWidth, captureBuffer + y * CAPTURE_WIDTH, captureWidth * sizeof(uint16_t));
+    }
+    return true;
+}
+
+void IconCache_::evict(size_t required)
+{
+    while (!entries.empty() && usedBytes + required > budget)
+    {
+        Entry &oldest = entries.back();
+        usedBytes -= oldest.width * oldest.height * sizeof(uint16_t);
+        index.erase(oldest.name);
+        delete[] oldest.pixels;
+        entries.pop_back();
+        ++evictions;
+    }
+}
+
+const uint16_t *IconCache_::get(fs::File &file, uint8_t &width, uint8_t &height)
+{
+    if (!file)
+        return nullptr;
+
+    String name = file.name();
+    auto it = index.find(name);
+    if (it != index.end())
+    {
+        // Move to the front so it is evicted last
+        entries.splice(entries.begin(), entries, it->second);
+        ++hits;
+        width = it->second->width;
+        height = it->second->height;
+        return it->second->pixels;
+    }
+
+    ++misses;
+    Entry entry;
+    entry.name = name;
+    if (!decode(file, entry))
+        return nullptr;
+
+    size_t size = entry.width * entry.height * sizeof(uint16_t);
+    if (size > budget)
+    {
+        delete[] entry.pixels;
+        return nullptr;
+    }
+
+    evict(size);
+    entries.push_front(entry);
+    index[name] = entries.begin();
+    usedBytes += size;
+    width = entry.width;
+    height = entry.height;
+    return entry.pixels;
+}
+
+void IconCache_::invalidate(const String &name)
+{
+    auto it = index.find(name);
+    if (it == index.end())
+        return;
+    DEBUG_PRINTLN("Invalidate cached icon " + name);
+    usedBytes -= it->second->width * it->second->height * sizeof(uint16_t);
+    delete[] it->second->pixels;
+    entries.erase(it->second);
+    index.erase(it);
+}
+
+void IconCache_::clear()
+{
+    for (auto &entry : entries)
+    {
+        delete[] entry.pixels;
+    }
+    entries.clear();
+    index.clear();
+    usedBytes = 0;
+}
+
+size_t IconCache_::getUsedBytes()
+{
+    return usedBytes;
+}
+
+size_t IconCache_::getCount()
+{
+    return entries.size();
+}
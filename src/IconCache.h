@@ -0,0 +1,47 @@
+#ifndef IconCache_h
+#define IconCache_h
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <list>
+#include <map>
+
+// Keeps decoded JPG icons in RAM so they are not decoded from LittleFS on every frame.
+// Entries are keyed by the icon file name and evicted in LRU order once the byte budget is exceeded.
+class IconCache_
+{
+private:
+    IconCache_() = default;
+
+    struct Entry
+    {
+        String name;
+        uint8_t width;
+        uint8_t height;
+        uint16_t *pixels;
+    };
+
+    std::list<Entry> entries; // most recently used first
+    std::map<String, std::list<Entry>::iterator> index;
+    size_t usedBytes = 0;
+    size_t budget = 8192;
+
+    bool decode(fs::File &file, Entry &entry);
+    void evict(size_t required);
+
+public:
+    static IconCache_ &getInstance();
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+    void setBudget(size_t bytes);
+    const uint16_t *get(fs::File &file, uint8_t &width, uint8_t &height);
+    void invalidate(const String &name);
+    void clear();
+    size_t getUsedBytes();
+    size_t getCount();
+};
+
+extern IconCache_ &IconCache;
+
+#endif
@@ -0,0 +1,104 @@
+#include "JsonArena.h"
+#include "Globals.h"
+
+// The getter for the instantiated singleton instance
+JsonArena_ &JsonArena_::getInstance()
+{
+    static JsonArena_ instance;
+    return instance;
+}
+
+// Initialize the global shared instance
+JsonArena_ &JsonArena = JsonArena.getInstance();
+
+// Allocates every arena with the new size. A busy arena keeps its document and is
+// reallocated the next time it is borrowed, as is an arena whose allocation failed.
+void JsonArena_::setSize(size_t bytes)
+{
+    size = bytes;
+    for (Arena &arena : arenas)
+    {
+        if (arena.busy)
+            continue;
+        if (arena.doc && arena.doc->capacity() == size)
+            continue;
+        delete arena.doc;
+        arena.doc = new DynamicJsonDocument(size);
+        arena.peak = 0;
+    }
+}
+
+size_t JsonArena_::getSize()
+{
+    return size;
+}
+
+bool JsonArena_::accepts(size_t length)
+{
+    if (length <= size)
+        return true;
+    DEBUG_PRINTLN(F("JSON payload exceeds the arena size"));
+    rejected++;
+    return false;
+}
+
+size_t JsonArena_::getUsedBytes(JsonArenaId id)
+{
+    return arenas[id].doc ? arenas[id].doc->memoryUsage() : 0;
+}
+
+size_t JsonArena_::getPeakBytes(JsonArenaId id)
+{
+    return arenas[id].peak;
+}
+
+JsonLease::JsonLease(JsonArenaId id)
+{
+    JsonArena_::Arena &candidate = JsonArena.arenas[id];
+    if (candidate.busy)
+    {
+        JsonArena.fallbacks++;
+        temporary = new DynamicJsonDocument(JsonArena.size);
+        return;
+    }
+    if (!candidate.doc || candidate.doc->capacity() != JsonArena.size)
+    {
+        delete candidate.doc;
+        candidate.doc = new DynamicJsonDocument(JsonArena.size);
+    }
+    candidate.doc->clear();
+    candidate.busy = true;
+    arena = &candidate;
+}
+
+JsonLease::~JsonLease()
+{
+    if (arena)
+        arena->busy = false;
+    delete temporary;
+}
+
+DynamicJsonDocument &JsonLease::doc()
+{
+    return arena ? *arena->doc : *temporary;
+}
+
+DeserializationError JsonLease::parse(const char *json, size_t length)
+{
+    if (!JsonArena.accepts(length))
+        return DeserializationError::NoMemory;
+    DeserializationError error = deserializeJson(doc(), json, length);
+    if (!error && arena)
+        arena->peak = max(arena->peak, arena->doc->memoryUsage());
+    return error;
+}
+
+DeserializationError JsonLease::parse(const char *json)
+{
+    return parse(json, strlen(json));
+}
+
+DeserializationError JsonLease::parse(const String &json)
+{
+    return parse(json.c_str(), json.length());
+}
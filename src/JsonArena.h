@@ -0,0 +1,67 @@
+#ifndef JsonArena_h
+#define JsonArena_h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+enum JsonArenaId
+{
+    ARENA_PAYLOAD,   // the inbound MQTT or HTTP message itself
+    ARENA_FRAGMENTS, // colored text fragments parsed while a message is processed
+    ARENA_COUNT
+};
+
+// Preallocated JSON documents for inbound payloads. Each arena is allocated by setSize() and
+// cleared when it is borrowed again, so parsing messages doesn't fragment the heap over time.
+// Payloads longer than the arena size are rejected before they are parsed.
+class JsonArena_
+{
+private:
+    JsonArena_() = default;
+
+    struct Arena
+    {
+        DynamicJsonDocument *doc = nullptr;
+        bool busy = false;
+        size_t peak = 0;
+    };
+
+    Arena arenas[ARENA_COUNT];
+    size_t size = 4096;
+
+    friend class JsonLease;
+
+public:
+    static JsonArena_ &getInstance();
+    uint32_t rejected = 0;
+    uint32_t fallbacks = 0; // leases that got a temporary document because their arena was busy
+    void setSize(size_t bytes);
+    size_t getSize();
+    bool accepts(size_t length);
+    size_t getUsedBytes(JsonArenaId id);
+    size_t getPeakBytes(JsonArenaId id);
+};
+
+extern JsonArena_ &JsonArena;
+
+// Borrows an arena for the current scope. Arenas are only used from the main loop,
+// a nested lease of an arena that is already borrowed gets a temporary document instead.
+class JsonLease
+{
+private:
+    JsonArena_::Arena *arena = nullptr;
+    DynamicJsonDocument *temporary = nullptr;
+
+public:
+    explicit JsonLease(JsonArenaId id);
+    ~JsonLease();
+    JsonLease(const JsonLease &) = delete;
+    JsonLease &operator=(const JsonLease &) = delete;
+
+    DynamicJsonDocument &doc();
+    DeserializationError parse(const char *json, size_t length);
+    DeserializationError parse(const char *json);
+    DeserializationError parse(const String &json);
+};
+
+#endif
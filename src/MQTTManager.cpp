@@ -8,6 +8,8 @@
 #include "Dictionary.h"
 #include "PeripheryManager.h"
 #include "UpdateManager.h"
+#include "Profiler.h"
+#include "JsonArena.h"
 
 WiFiClient espClient;
 HADevice device;
@@ -86,20 +88,20 @@ void onRGBColorCommand(HALight::RGBColor color, HALight *sender)
 {
     if (sender == Matrix)
     {
-        TEXTCOLOR_565 = ((color.red & 0x1F) << 11) | ((color.green & 0x3F) << 5) | (color.blue & 0x1F);
+        TEXTCOLOR_888 = CRGB(color.red, color.green, color.blue);
         saveSettings();
     }
     else if (sender == Indikator1)
     {
-        DisplayManager.setIndicator1Color(((color.red & 0x1F) << 11) | ((color.green & 0x3F) << 5) | (color.blue & 0x1F));
+        DisplayManager.setIndicator1Color(CRGB(color.red, color.green, color.blue));
     }
     else if (sender == Indikator2)
     {
-        DisplayManager.setIndicator2Color(((color.red & 0x1F) << 11) | ((color.green & 0x3F) << 5) | (color.blue & 0x1F));
+        DisplayManager.setIndicator2Color(CRGB(color.red, color.green, color.blue));
     }
     else if (sender == Indikator3)
     {
-        DisplayManager.setIndicator3Color(((color.red & 0x1F) << 11) | ((color.green & 0x3F) << 5) | (color.blue & 0x1F));
+        DisplayManager.setIndicator3Color(CRGB(color.red, color.green, color.blue));
     }
     sender->setRGBColor(color); // report color back to the Home Assistant
 }
@@ -156,6 +158,10 @@ void onMqttMessage(const char *topic, const uint8_t *payload, uint16_t length)
 {
     DEBUG_PRINTF("MQTT message received at topic %s", topic);
     String strTopic = String(topic);
+    if (!JsonArena.accepts(length))
+    {
+        return;
+    }
     char *payloadCopy = new char[length + 1];
     memcpy(payloadCopy, payload, length);
     payloadCopy[length] = '\0';
@@ -243,11 +249,13 @@ void onMqttMessage(const char *topic, const uint8_t *payload, uint16_t length)
 
     if (strTopic.equals(MQTT_PREFIX + "/power"))
     {
-        StaticJsonDocument<128> doc;
-        DeserializationError error = deserializeJson(doc, payload);
+        JsonLease lease(ARENA_PAYLOAD);
+        DynamicJsonDocument &doc = lease.doc();
+        DeserializationError error = lease.parse(payloadCopy, length);
         if (error)
         {
             DEBUG_PRINTLN(F("Failed to parse json"));
+            delete[] payloadCopy;
             return;
         }
         if (doc.containsKey("power"))
@@ -310,7 +318,14 @@ void onMqttMessage(const char *topic, const uint8_t *payload, uint16_t length)
         if (topic_str.startsWith(prefix))
         {
             topic_str = topic_str.substring(prefix.length());
-            DisplayManager.parseCustomPage(topic_str, payloadCopy);
+            if (topic_str.endsWith("/patch"))
+            {
+                DisplayManager.patchCustomPage(topic_str.substring(0, topic_str.length() - 6), payloadCopy);
+            }
+            else
+            {
+                DisplayManager.parseCustomPage(topic_str, payloadCopy);
+            }
         }
 
         delete[] payloadCopy;
@@ -417,12 +432,9 @@ void MQTTManager_::setup()
 
         HALight::RGBColor color;
         color.isSet = true;
-        color.red = (TEXTCOLOR_565 >> 11) & 0x1F;  // Bitverschiebung um 11 Bits und Maskierung mit 0x1F
-        color.green = (TEXTCOLOR_565 >> 5) & 0x3F; // Bitverschiebung um 5 Bits und Maskierung mit 0x3F
-        color.blue = TEXTCOLOR_565 & 0x1F;         // Maskierung mit 0x1F
-        color.red <<= 3;
-        color.green <<= 2;
-        color.blue <<= 3;
+        color.red = TEXTCOLOR_888.r;
+        color.green = TEXTCOLOR_888.g;
+        color.blue = TEXTCOLOR_888.b;
         Matrix->setCurrentRGBColor(color);
         Matrix->setState(true, true);
 
@@ -646,12 +658,9 @@ void MQTTManager_::sendStats()
         Matrix->setState(!MATRIX_OFF, false);
         HALight::RGBColor color;
         color.isSet = true;
-        color.red = (TEXTCOLOR_565 >> 11) & 0x1F;
-        color.green = (TEXTCOLOR_565 >> 5) & 0x3F;
-        color.blue = TEXTCOLOR_565 & 0x1F;
-        color.red <<= 3;
-        color.green <<= 2;
-        color.blue <<= 3;
+        color.red = TEXTCOLOR_888.r;
+        color.green = TEXTCOLOR_888.g;
+        color.blue = TEXTCOLOR_888.b;
         Matrix->setRGBColor(color);
         int8_t rssiValue = WiFi.RSSI();
         char rssiString[4];
@@ -673,6 +682,9 @@ void MQTTManager_::sendStats()
     }
 
     publish(StatsTopic, DisplayManager.getStats().c_str());
+#ifdef PERF_PROFILING
+    publish("stats/perf", Profiler.getStats().c_str());
+#endif
 }
 
 void MQTTManager_::sendButton(byte btn, bool state)
@@ -714,18 +726,15 @@ void MQTTManager_::sendButton(byte btn, bool state)
     }
 }
 
-void MQTTManager_::setIndicatorState(uint8_t indicator, bool state, uint16_t color)
+void MQTTManager_::setIndicatorState(uint8_t indicator, bool state, const CRGB &color)
 {
     if (HA_DISCOVERY)
     {
         HALight::RGBColor c;
         c.isSet = true;
-        c.red = (color >> 11) & 0x1F;
-        c.green = (color >> 5) & 0x3F;
-        c.blue = color & 0x1F;
-        c.red <<= 3;
-        c.green <<= 2;
-        c.blue <<= 3;
+        c.red = color.r;
+        c.green = color.g;
+        c.blue = color.b;
 
         switch (indicator)
         {
@@ -2,6 +2,7 @@
 #define MQTTManager_h
 
 #include <Arduino.h>
+#include <FastLED.h>
 
 class MQTTManager_
 {
@@ -17,7 +18,7 @@ public:
     void setCurrentApp(String);
     void sendStats();
     void sendButton(byte, bool);
-    void setIndicatorState(uint8_t, bool, uint16_t);
+    void setIndicatorState(uint8_t, bool, const CRGB &);
     void beginPublish(const char *topic, unsigned int plength, boolean retained);
     void writePayload(const char *data, const uint16_t length);
     void endPublish();
@@ -30,6 +30,9 @@
 #include "MatrixDisplayUi.h"
 #include "Fonts/AwtrixFont.h"
 #include "effects.h"
+#include <esp_timer.h>
+#include "Profiler.h"
+#include "Canvas.h"
 
 GifPlayer gif1;
 GifPlayer gif2;
@@ -47,17 +50,12 @@ void MatrixDisplayUi::init()
   this->matrix->setFont(&AwtrixFont);
   gif1.setMatrix(this->matrix);
   gif2.setMatrix(this->matrix);
+  this->switchState();
 }
 
 void MatrixDisplayUi::setTargetFPS(uint8_t fps)
 {
-  float oldInterval = this->updateInterval;
-  this->updateInterval = ((float)1.0 / (float)fps) * 1000;
-
-  // Calculate new ticksPerApp
-  float changeRatio = oldInterval / (float)this->updateInterval;
-  // this->ticksPerApp *= changeRatio;
-  this->ticksPerTransition *= changeRatio;
+  this->updateInterval = 1000000L / fps;
 }
 
 void MatrixDisplayUi::setBackgroundEffect(int effect)
@@ -87,11 +85,11 @@ void MatrixDisplayUi::setsetAutoTransitionBackwards()
 }
 void MatrixDisplayUi::setTimePerApp(long time)
 {
-  this->ticksPerApp = time / updateInterval;
+  this->timePerApp = time;
 }
 void MatrixDisplayUi::setTimePerTransition(uint16_t time)
 {
-  this->ticksPerTransition = (int)((float)time / (float)updateInterval);
+  this->timePerTransition = time;
 }
 
 // -/----- App settings -----\-
@@ -100,25 +98,41 @@ void MatrixDisplayUi::setAppAnimation(AnimationDirection dir)
   this->appAnimationDirection = dir;
 }
 
-void MatrixDisplayUi::setApps(const std::vector<std::pair<String, AppCallback>> &appPairs)
+void MatrixDisplayUi::setTransitionEffect(TransitionEffect effect)
 {
+  this->transitionEffect = effect;
+}
 
-  delete[] AppFunctions;
-  AppCount = appPairs.size();
-  AppFunctions = new AppCallback[AppCount];
-  for (size_t i = 0; i < AppCount; ++i)
+void MatrixDisplayUi::setApps(const std::vector<AppEntry> &appEntries, bool announce)
+{
+  uint16_t currentId = this->state.currentApp < AppCount ? apps[this->state.currentApp].id : 0;
+  apps = appEntries;
+  AppCount = apps.size();
+#ifdef PERF_PROFILING
+  appStages.clear();
+  for (const auto &app : apps)
   {
-    AppFunctions[i] = appPairs[i].second;
+    appStages.push_back(Profiler.stage(("app:" + app.name).c_str()));
   }
-  this->resetState();
-  DisplayManager.sendAppLoop();
+#endif
+  this->resetState(currentId);
+  if (announce)
+    DisplayManager.sendAppLoop();
 }
 
 // -/----- Overlays ------\-
-void MatrixDisplayUi::setOverlays(OverlayCallback *overlayFunctions, uint8_t overlayCount)
+void MatrixDisplayUi::setOverlays(OverlayCallback *overlayFunctions, const char *const *overlayNames, uint8_t overlayCount)
 {
   this->overlayFunctions = overlayFunctions;
+  this->overlayNames = overlayNames;
   this->overlayCount = overlayCount;
+#ifdef PERF_PROFILING
+  overlayStages.clear();
+  for (uint8_t i = 0; i < overlayCount; i++)
+  {
+    overlayStages.push_back(Profiler.stage(overlayNames[i]));
+  }
+#endif
 }
 
 void MatrixDisplayUi::setBackground(BackgroundCallback backgroundFunction)
@@ -133,7 +147,7 @@ void MatrixDisplayUi::nextApp()
   {
     this->state.manuelControll = true;
     this->state.appState = IN_TRANSITION;
-    this->state.ticksSinceLastStateSwitch = 0;
+    this->switchState();
     this->lastTransitionDirection = this->state.appTransitionDirection;
     this->state.appTransitionDirection = 1;
   }
@@ -144,17 +158,17 @@ void MatrixDisplayUi::previousApp()
   {
     this->state.manuelControll = true;
     this->state.appState = IN_TRANSITION;
-    this->state.ticksSinceLastStateSwitch = 0;
+    this->switchState();
     this->lastTransitionDirection = this->state.appTransitionDirection;
     this->state.appTransitionDirection = -1;
   }
 }
 
-bool MatrixDisplayUi::switchToApp(uint8_t app)
+bool MatrixDisplayUi::switchToApp(uint16_t app)
 {
   if (app >= this->AppCount)
     return false;
-  this->state.ticksSinceLastStateSwitch = 0;
+  this->switchState();
   if (app == this->state.currentApp)
     return false;
   this->state.appState = FIXED;
@@ -162,11 +176,11 @@ bool MatrixDisplayUi::switchToApp(uint8_t app)
   return true;
 }
 
-void MatrixDisplayUi::transitionToApp(uint8_t app)
+void MatrixDisplayUi::transitionToApp(uint16_t app)
 {
   if (app >= this->AppCount)
     return;
-  this->state.ticksSinceLastStateSwitch = 0;
+  this->switchState();
   if (app == this->state.currentApp)
     return;
   this->nextAppNumber = app;
@@ -183,37 +197,82 @@ MatrixDisplayUiState *MatrixDisplayUi::getUiState()
   return &this->state;
 }
 
-int8_t MatrixDisplayUi::update()
+const FramePacing &MatrixDisplayUi::getFramePacing()
+{
+  return this->pacing;
+}
+
+void MatrixDisplayUi::switchState()
+{
+  this->state.lastStateSwitch = esp_timer_get_time();
+}
+
+long MatrixDisplayUi::timeSinceStateSwitch()
 {
-  long appStart = millis();
-  int8_t timeBudget = this->updateInterval - (appStart - this->state.lastUpdate);
-  if (timeBudget <= 0)
+  return (esp_timer_get_time() - this->state.lastStateSwitch) / 1000;
+}
+
+void MatrixDisplayUi::recordFrameInterval(int64_t interval, int64_t now)
+{
+  this->pacing.frames++;
+  if (interval > this->updateInterval * 3 / 2)
+    this->pacing.lateFrames++;
+
+  int64_t deviation = interval - this->updateInterval;
+  if (deviation < 0)
+    deviation = -deviation;
+  this->pacing.jitter += ((int32_t)deviation - (int32_t)this->pacing.jitter) / 16;
+
+  uint8_t bucket = 0;
+  while (bucket < FRAME_HISTOGRAM_BUCKETS - 1 && interval > FRAME_HISTOGRAM_LIMITS[bucket] * 1000L)
+    bucket++;
+  this->pacing.histogram[bucket]++;
+
+  this->pacingWindowFrames++;
+  if (now - this->pacingWindowStart >= 1000000)
   {
-    // Implement frame skipping to ensure time budget is keept
-    if (this->setAutoTransition && this->state.lastUpdate != 0)
-      this->state.ticksSinceLastStateSwitch += ceil(-timeBudget / this->updateInterval);
+    this->pacing.fps = this->pacingWindowFrames * 1000000.0f / (now - this->pacingWindowStart);
+    this->pacingWindowFrames = 0;
+    this->pacingWindowStart = now;
+  }
+}
 
-    this->state.lastUpdate = appStart;
+// Returns the time in ms until the next frame is due
+long MatrixDisplayUi::update()
+{
+  int64_t now = esp_timer_get_time();
+  int64_t interval = now - this->state.lastUpdate;
+  if (this->state.lastUpdate == 0 || interval >= this->updateInterval)
+  {
+    if (this->state.lastUpdate == 0)
+    {
+      this->state.frameScale = 1;
+    }
+    else
+    {
+      this->recordFrameInterval(interval, now);
+      // Limit the catch up after long stalls
+      this->state.frameScale = min((float)interval / this->updateInterval, 10.0f);
+    }
+    this->state.lastUpdate = now;
     this->tick();
   }
 
-  return this->updateInterval - (millis() - appStart);
+  return (this->updateInterval - (esp_timer_get_time() - this->state.lastUpdate)) / 1000;
 }
 
 void MatrixDisplayUi::tick()
 {
-  this->state.ticksSinceLastStateSwitch++;
-
   if (this->AppCount > 0)
   {
     switch (this->state.appState)
     {
     case IN_TRANSITION:
-      if (this->state.ticksSinceLastStateSwitch >= this->ticksPerTransition)
+      if (this->timeSinceStateSwitch() >= this->timePerTransition)
       {
         this->state.appState = FIXED;
         this->state.currentApp = getnextAppNumber();
-        this->state.ticksSinceLastStateSwitch = 0;
+        this->switchState();
         this->nextAppNumber = -1;
       }
       break;
@@ -224,146 +283,250 @@ void MatrixDisplayUi::tick()
         this->state.appTransitionDirection = 1;
         this->state.manuelControll = false;
       }
-      if (this->state.ticksSinceLastStateSwitch >= this->ticksPerApp)
+      if (this->timeSinceStateSwitch() >= this->timePerApp)
       {
         if (this->setAutoTransition)
         {
           this->state.appState = IN_TRANSITION;
         }
-        this->state.ticksSinceLastStateSwitch = 0;
+        this->switchState();
       }
       break;
     }
   }
 
   this->matrix->clear();
-  
+
+  // The app layers of a transition are rendered before the background so they
+  // can be composited on top of it
+  if (this->AppCount > 0 && this->state.appState == IN_TRANSITION)
+    this->renderTransitionLayers();
+
   if (BackgroundEffect>-1)
   {
+    PROFILE_STAGE("effect");
     callEffect(this->matrix, 0, 0, BackgroundEffect);
   }
 
   if (this->AppCount > 0)
     this->drawApp();
   this->drawOverlays();
-  this->drawIndicators();
-  DisplayManager.gammaCorrection();
-  this->matrix->show();
+  {
+    PROFILE_STAGE("indicators");
+    this->drawIndicators();
+  }
+  {
+    PROFILE_STAGE("gamma");
+    DisplayManager.gammaCorrection();
+  }
+  {
+    PROFILE_STAGE("show");
+    DisplayManager.showFrame();
+  }
 }
 
 void MatrixDisplayUi::drawIndicators()
 {
+  Canvas &canvas = Canvas::getInstance();
 
   if (indicator1State && indicator1Blink && (millis() % (2 * indicator1Blink)) < indicator1Blink)
   {
-    matrix->drawPixel(31, 0, indicator1Color);
-    matrix->drawPixel(30, 0, indicator1Color);
-    matrix->drawPixel(31, 1, indicator1Color);
+    canvas.setPixel(31, 0, indicator1Color);
+    canvas.setPixel(30, 0, indicator1Color);
+    canvas.setPixel(31, 1, indicator1Color);
   }
 
   if (indicator2State && indicator2Blink && (millis() % (2 * indicator2Blink)) < indicator2Blink)
   {
-    matrix->drawPixel(31, 3, indicator2Color);
-    matrix->drawPixel(31, 4, indicator2Color);
+    canvas.setPixel(31, 3, indicator2Color);
+    canvas.setPixel(31, 4, indicator2Color);
   }
 
   if (indicator3State && indicator3Blink && (millis() % (2 * indicator3Blink)) < indicator3Blink)
   {
-    matrix->drawPixel(31, 7, indicator3Color);
-    matrix->drawPixel(31, 6, indicator3Color);
-    matrix->drawPixel(30, 7, indicator3Color);
+    canvas.setPixel(31, 7, indicator3Color);
+    canvas.setPixel(31, 6, indicator3Color);
+    canvas.setPixel(30, 7, indicator3Color);
   }
 
   if (indicator1State && !indicator1Blink)
   {
-    matrix->drawPixel(31, 0, indicator1Color);
-    matrix->drawPixel(30, 0, indicator1Color);
-    matrix->drawPixel(31, 1, indicator1Color);
+    canvas.setPixel(31, 0, indicator1Color);
+    canvas.setPixel(30, 0, indicator1Color);
+    canvas.setPixel(31, 1, indicator1Color);
   }
 
   if (indicator2State && !indicator2Blink)
   {
-    matrix->drawPixel(31, 3, indicator2Color);
-    matrix->drawPixel(31, 4, indicator2Color);
+    canvas.setPixel(31, 3, indicator2Color);
+    canvas.setPixel(31, 4, indicator2Color);
   }
 
   if (indicator3State && !indicator3Blink)
   {
-    matrix->drawPixel(31, 7, indicator3Color);
-    matrix->drawPixel(31, 6, indicator3Color);
-    matrix->drawPixel(30, 7, indicator3Color);
+    canvas.setPixel(31, 7, indicator3Color);
+    canvas.setPixel(31, 6, indicator3Color);
+    canvas.setPixel(30, 7, indicator3Color);
+  }
+}
+
+float MatrixDisplayUi::transitionProgress()
+{
+  return min((float)this->timeSinceStateSwitch() / this->timePerTransition, 1.0f);
+}
+
+// Renders an app into the black framebuffer and moves what it drew into the layer
+void MatrixDisplayUi::renderLayer(uint16_t app, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, CanvasLayer &layer)
+{
+  Canvas &canvas = Canvas::getInstance();
+  uint8_t *outer = canvas.beginLayer(layer);
+  this->callApp(app, firstFrame, lastFrame, gifPlayer);
+  canvas.endLayer(layer, outer);
+}
+
+// Renders both apps of the transition into their layers. The outgoing app is only
+// rendered on the first transition frame, so every frame costs a single app render.
+void MatrixDisplayUi::renderTransitionLayers()
+{
+  float progress = this->transitionProgress();
+  bool FirstApp = progress < 0.2;
+  bool LastApp = progress > 0.8;
+  if (this->outgoingSnapshot != this->state.lastStateSwitch)
+  {
+    this->renderLayer(this->state.currentApp, FirstApp, LastApp, &gif1, this->outgoingLayer);
+    this->outgoingSnapshot = this->state.lastStateSwitch;
+  }
+  this->renderLayer(this->getnextAppNumber(), FirstApp, LastApp, &gif2, this->incomingLayer);
+}
+
+// Draws the blend of both transition layers over the background. Pixels an app
+// did not draw show the background, pixels it drew black hide it.
+void MatrixDisplayUi::compositeTransition()
+{
+  Canvas &canvas = Canvas::getInstance();
+  int16_t w = canvas.width();
+  int16_t h = canvas.height();
+  const CanvasLayer &outgoing = this->outgoingLayer;
+  const CanvasLayer &incoming = this->incomingLayer;
+  if (outgoing.pixels.size() != (size_t)(w * h) || incoming.pixels.size() != (size_t)(w * h))
+    return;
+
+  float progress = this->transitionProgress();
+  // Invert animation if direction is reversed.
+  int8_t dir = this->state.appTransitionDirection >= 0 ? 1 : -1;
+
+  // Slides move the outgoing layer by shift and let the incoming layer follow one screen behind it
+  int16_t shiftX = 0, shiftY = 0, followX = 0, followY = 0;
+  if (this->transitionEffect == TRANSITION_SLIDE_HORIZONTAL)
+  {
+    shiftX = -dir * (int16_t)(w * progress);
+    followX = -dir * w;
+  }
+  else
+  {
+    int8_t sign = this->appAnimationDirection == SLIDE_DOWN ? dir : -dir;
+    shiftY = sign * (int16_t)(h * progress);
+    followY = sign * h;
+  }
+  fract8 amount = progress * 255;
+  int16_t edge = w * progress;
+
+  // Draws the pixel of a layer if its app drew it
+  auto draw = [&canvas](int16_t x, int16_t y, const CanvasLayer &layer, uint16_t i)
+  {
+    if (layer.covers(i))
+      canvas.at(x, y) = layer.pixels[i];
+  };
+
+  for (int16_t y = 0; y < h; y++)
+  {
+    for (int16_t x = 0; x < w; x++)
+    {
+      uint16_t i = y * w + x;
+      switch (this->transitionEffect)
+      {
+      case TRANSITION_FADE:
+      {
+        // A pixel only one app drew fades from or to the background
+        bool from = outgoing.covers(i);
+        bool to = incoming.covers(i);
+        if (from || to)
+        {
+          CRGB &pixel = canvas.at(x, y);
+          pixel = blend(from ? outgoing.pixels[i] : pixel, to ? incoming.pixels[i] : pixel, amount);
+        }
+        break;
+      }
+      case TRANSITION_WIPE:
+        draw(x, y, (dir > 0 ? x < edge : x >= w - edge) ? incoming : outgoing, i);
+        break;
+      default:
+      {
+        int16_t sx = x - shiftX;
+        int16_t sy = y - shiftY;
+        if (canvas.contains(sx, sy))
+        {
+          draw(x, y, outgoing, sy * w + sx);
+          break;
+        }
+        sx += followX;
+        sy += followY;
+        if (canvas.contains(sx, sy))
+          draw(x, y, incoming, sy * w + sx);
+        break;
+      }
+      }
+    }
   }
 }
 
+void MatrixDisplayUi::callApp(uint16_t app, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer)
+{
+  PROFILE_STAGE_INDEX(this->appStages[app]);
+  const AppEntry &entry = this->apps[app];
+  entry.callback(this->matrix, &this->state, 0, 0, firstFrame, lastFrame, gifPlayer, entry.context);
+}
+
 void MatrixDisplayUi::drawApp()
 {
   switch (this->state.appState)
   {
   case IN_TRANSITION:
   {
-    float progress = (float)this->state.ticksSinceLastStateSwitch / (float)this->ticksPerTransition;
-    int16_t x, y, x1, y1;
-    switch (this->appAnimationDirection)
-    {
-    case SLIDE_UP:
-      x = 0;
-      y = -8 * progress;
-      x1 = 0;
-      y1 = y + 8;
-      break;
-    case SLIDE_DOWN:
-      x = 0;
-      y = 8 * progress;
-      x1 = 0;
-      y1 = y - 8;
-      break;
-    }
-    // Invert animation if direction is reversed.
-    int8_t dir = this->state.appTransitionDirection >= 0 ? 1 : -1;
-    x *= dir;
-    y *= dir;
-    x1 *= dir;
-    y1 *= dir;
-    bool FirstApp = progress < 0.2;
-    bool LastApp = progress > 0.8;
-    this->matrix->drawRect(x, y, x1, y1, matrix->Color(0, 0, 0));
-    (this->AppFunctions[this->state.currentApp])(this->matrix, &this->state, x, y, FirstApp, LastApp, &gif1);
-    (this->AppFunctions[this->getnextAppNumber()])(this->matrix, &this->state, x1, y1, FirstApp, LastApp, &gif2);
+    PROFILE_STAGE("transition");
+    this->compositeTransition();
     break;
   }
   case FIXED:
-    (this->AppFunctions[this->state.currentApp])(this->matrix, &this->state, 0, 0, false, false, &gif2);
+    this->callApp(this->state.currentApp, false, false, &gif2);
     break;
   }
 }
 
-bool MatrixDisplayUi::isCurrentAppValid()
+// Keeps showing the current app if it is still in the loop, even if its position changed
+void MatrixDisplayUi::resetState(uint16_t currentId)
 {
-  for (size_t i = 0; i < AppCount; ++i)
+  for (uint16_t i = 0; i < AppCount; ++i)
   {
-    if (AppFunctions[i] == AppFunctions[this->state.currentApp])
+    if (apps[i].id == currentId)
     {
-      return true;
+      this->state.currentApp = i;
+      if (this->nextAppNumber >= AppCount)
+        this->nextAppNumber = -1;
+      return;
     }
   }
-  return false;
-}
-
-void MatrixDisplayUi::resetState()
-{
-  if (!isCurrentAppValid())
-  {
-    this->state.lastUpdate = 0;
-    this->state.ticksSinceLastStateSwitch = 0;
-    this->state.appState = FIXED;
-    this->state.currentApp = 0;
-  }
+  this->state.lastUpdate = 0;
+  this->switchState();
+  this->state.appState = FIXED;
+  this->state.currentApp = 0;
+  this->nextAppNumber = -1;
 }
 
 void MatrixDisplayUi::forceResetState()
 {
   this->state.lastUpdate = 0;
-  this->state.ticksSinceLastStateSwitch = 0;
+  this->switchState();
   this->state.appState = FIXED;
   this->state.currentApp = 0;
 }
@@ -372,6 +535,7 @@ void MatrixDisplayUi::drawOverlays()
 {
   for (uint8_t i = 0; i < this->overlayCount; i++)
   {
+    PROFILE_STAGE_INDEX(this->overlayStages[i]);
     (this->overlayFunctions[i])(this->matrix, &this->state, &gif2);
   }
 }
@@ -381,14 +545,14 @@ void MatrixDisplayUi::drawBackground()
   this->backgroundFunction(this->matrix);
 }
 
-uint8_t MatrixDisplayUi::getnextAppNumber()
+uint16_t MatrixDisplayUi::getnextAppNumber()
 {
   if (this->nextAppNumber != -1)
     return this->nextAppNumber;
   return (this->state.currentApp + this->AppCount + this->state.appTransitionDirection) % this->AppCount;
 }
 
-void MatrixDisplayUi::setIndicator1Color(uint16_t color)
+void MatrixDisplayUi::setIndicator1Color(const CRGB &color)
 {
   this->indicator1Color = color;
 }
@@ -403,7 +567,7 @@ void MatrixDisplayUi::setIndicator1Blink(int blink)
   this->indicator1Blink = blink;
 }
 
-void MatrixDisplayUi::setIndicator2Color(uint16_t color)
+void MatrixDisplayUi::setIndicator2Color(const CRGB &color)
 {
   this->indicator2Color = color;
 }
@@ -418,7 +582,7 @@ void MatrixDisplayUi::setIndicator2Blink(int blink)
   this->indicator2Blink = blink;
 }
 
-void MatrixDisplayUi::setIndicator3Color(uint16_t color)
+void MatrixDisplayUi::setIndicator3Color(const CRGB &color)
 {
   this->indicator3Color = color;
 }
@@ -29,6 +29,7 @@
 #define MatrixDisplayUi_h
 
 #include <Arduino.h>
+#include <vector>
 #include "FastLED_NeoMatrix.h"
 #include "GifPlayer.h"
 #include "DisplayManager.h"
@@ -43,21 +44,48 @@ enum AnimationDirection
   SLIDE_DOWN
 };
 
+enum TransitionEffect
+{
+  TRANSITION_SLIDE,
+  TRANSITION_FADE,
+  TRANSITION_SLIDE_HORIZONTAL,
+  TRANSITION_WIPE
+};
+
 enum AppState
 {
   IN_TRANSITION,
   FIXED
 };
 
+#define FRAME_HISTOGRAM_BUCKETS 8
+
+// Upper limits in ms of the frame interval histogram buckets, the last bucket takes everything above
+const uint16_t FRAME_HISTOGRAM_LIMITS[FRAME_HISTOGRAM_BUCKETS - 1] = {10, 20, 30, 40, 60, 100, 200};
+
+// Frame pacing telemetry, intervals are measured between the start of two frames
+struct FramePacing
+{
+  uint32_t frames = 0;
+  uint32_t lateFrames = 0; // frames that started more than half an interval late
+  float fps = 0;           // measured over the last second
+  uint32_t jitter = 0;     // average deviation from the target interval in µs
+  uint32_t histogram[FRAME_HISTOGRAM_BUCKETS] = {0};
+};
+
 // Structure of the UiState
 struct MatrixDisplayUiState
 {
+  // Monotonic timestamps in µs
+  int64_t lastUpdate = 0;
+  int64_t lastStateSwitch = 0;
 
-  u_int64_t lastUpdate = 0;
-  long ticksSinceLastStateSwitch = 0;
+  // Elapsed time of the current frame in target frame intervals,
+  // used to make movement independent of the actual frame rate
+  float frameScale = 1;
 
   AppState appState = FIXED;
-  uint8_t currentApp = 0;
+  uint16_t currentApp = 0;
 
   // Normal = 1, Inverse = -1;
   int8_t appTransitionDirection = 1;
@@ -68,10 +96,23 @@ struct MatrixDisplayUiState
   void *userData = NULL;
 };
 
-typedef void (*AppCallback)(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer);
+typedef void (*AppCallback)(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x, int16_t y, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, void *context);
 typedef void (*OverlayCallback)(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, GifPlayer *gifPlayer);
 typedef void (*BackgroundCallback)(FastLED_NeoMatrix *matrix);
 
+// An app in the loop. The callback gets the context of its entry, so apps
+// sharing one callback don't need to look up their state by name.
+struct AppEntry
+{
+  String name;
+  AppCallback callback;
+  void *context = nullptr;
+  uint16_t id = 0; // stays the same while the app exists, unlike its position in the loop
+
+  AppEntry(const String &name, AppCallback callback, uint16_t id, void *context = nullptr)
+      : name(name), callback(callback), context(context), id(id) {}
+};
+
 class MatrixDisplayUi
 {
 private:
@@ -79,20 +120,32 @@ private:
 
   // Values for the Apps
   AnimationDirection appAnimationDirection = SLIDE_DOWN;
+  TransitionEffect transitionEffect = TRANSITION_SLIDE;
   int8_t lastTransitionDirection = 1;
 
-  long ticksPerApp = 151;           // ~ 5000ms at 30 FPS
-  uint16_t ticksPerTransition = 15; // ~  500ms at 30 FPS
+  long timePerApp = 5000;         // ms
+  uint16_t timePerTransition = 500; // ms
 
   bool setAutoTransition = true;
   bool lastFrameShown;
-  AppCallback *AppFunctions = nullptr;
+  std::vector<AppEntry> apps;
+#ifdef PERF_PROFILING
+  std::vector<uint8_t> appStages;
+  std::vector<uint8_t> overlayStages;
+#endif
 
   // Internally used to transition to a specific app
-  int8_t nextAppNumber = -1;
+  int16_t nextAppNumber = -1;
+
+  // App layers of the running transition, the outgoing one is
+  // rendered once when the transition starts and then stays frozen
+  CanvasLayer outgoingLayer;
+  CanvasLayer incomingLayer;
+  int64_t outgoingSnapshot = -1; // state switch the outgoing layer belongs to
 
   // Values for Overlays
   OverlayCallback *overlayFunctions;
+  const char *const *overlayNames;
   BackgroundCallback backgroundFunction;
   uint8_t overlayCount = 0;
   int BackgroundEffect;
@@ -100,24 +153,35 @@ private:
   MatrixDisplayUiState state;
 
   // Bookeeping for update
-  long updateInterval = 33;
-
+  long updateInterval = 33333; // µs
+  FramePacing pacing;
+  uint32_t pacingWindowFrames = 0;
+  int64_t pacingWindowStart = 0;
+
+  void recordFrameInterval(int64_t interval, int64_t now);
+  long timeSinceStateSwitch();
+  void switchState();
+
+  float transitionProgress();
+  void renderLayer(uint16_t app, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer, CanvasLayer &layer);
+  void renderTransitionLayers();
+  void compositeTransition();
+  void callApp(uint16_t app, bool firstFrame, bool lastFrame, GifPlayer *gifPlayer);
   void drawApp();
   void drawOverlays();
   void drawBackground();
   void tick();
-  void resetState();
-  bool isCurrentAppValid();
+  void resetState(uint16_t currentId);
 
 public:
   MatrixDisplayUi(FastLED_NeoMatrix *matrix);
-  uint8_t AppCount = 0;
+  uint16_t AppCount = 0;
   /**
    * Initialise the display
    */
   void init();
 
-  uint8_t getnextAppNumber();
+  uint16_t getnextAppNumber();
   /**
    * Configure the internal used target FPS
    */
@@ -151,15 +215,15 @@ public:
    */
   void setTimePerTransition(uint16_t time);
 
-  void setIndicator1Color(uint16_t color);
+  void setIndicator1Color(const CRGB &color);
   void setIndicator1State(bool state);
   void setIndicator1Blink(int Blink);
 
-  void setIndicator2Color(uint16_t color);
+  void setIndicator2Color(const CRGB &color);
   void setIndicator2State(bool state);
   void setIndicator2Blink(int Blink);
 
-  void setIndicator3Color(uint16_t color);
+  void setIndicator3Color(const CRGB &color);
   void setIndicator3State(bool state);
   void setIndicator3Blink(int Blink);
 
@@ -174,16 +238,21 @@ public:
   void setAppAnimation(AnimationDirection dir);
 
   /**
-   * Add app drawing functions
+   * Configure how the outgoing and incoming app are combined during a transition
+   */
+  void setTransitionEffect(TransitionEffect effect);
+
+  /**
+   * Add app drawing functions, announce = false skips publishing the new loop
    */
-  void setApps(const std::vector<std::pair<String, AppCallback>> &appPairs);
+  void setApps(const std::vector<AppEntry> &appEntries, bool announce = true);
 
   // Overlay
   void forceResetState();
   /**
    * Add overlays drawing functions that are draw independent of the Apps
    */
-  void setOverlays(OverlayCallback *overlayFunctions, uint8_t overlayCount);
+  void setOverlays(OverlayCallback *overlayFunctions, const char *const *overlayNames, uint8_t overlayCount);
   void setBackground(BackgroundCallback backgroundfunction);
   // Manual Control
   void nextApp();
@@ -192,22 +261,23 @@ public:
   /**
    * Switch without transition to app `app`.
    */
-  bool switchToApp(uint8_t app);
+  bool switchToApp(uint16_t app);
 
   /**
    * Transition to app `app`, when the `app` number is bigger than the current
    * app the forward animation will be used, otherwise the backwards animation is used.
    */
-  void transitionToApp(uint8_t app);
+  void transitionToApp(uint16_t app);
 
   // State Info
   MatrixDisplayUiState *getUiState();
 
-  int8_t update();
+  long update();
+  const FramePacing &getFramePacing();
 
-  uint16_t indicator1Color = 63488;
-  uint16_t indicator2Color = 31;
-  uint16_t indicator3Color = 65504;
+  CRGB indicator1Color = CRGB(255, 0, 0);
+  CRGB indicator2Color = CRGB(0, 0, 255);
+  CRGB indicator3Color = CRGB(255, 255, 0);
 
   bool indicator1State = false;
   bool indicator2State = false;
@@ -131,7 +131,7 @@ String MenuManager_::menutext()
         return AUTO_BRIGHTNESS ? "AUTO" : String(BRIGHTNESS_PERCENT) + "%";
     case ColorMenu:
         DisplayManager.drawMenuIndicator(currentColor, sizeof(textColors) / sizeof(textColors[0]), 0xFBC0);
-        DisplayManager.setTextColor(textColors[currentColor]);
+        DisplayManager.setTextColor(rgb565ToRgb(textColors[currentColor]));
         return "0x" + String(textColors[currentColor], HEX);
     case SwitchMenu:
         return AUTO_TRANSITION ? "ON" : "OFF";
@@ -428,7 +428,7 @@ void MenuManager_::selectButtonLong()
             saveSettings();
             break;
         case ColorMenu:
-            TEXTCOLOR_565 = textColors[currentColor];
+            TEXTCOLOR_888 = rgb565ToRgb(textColors[currentColor]);
             saveSettings();
             break;
         case MainMenu:
@@ -0,0 +1,355 @@
+#ifndef NotificationQueue_h
+#define NotificationQueue_h
+
+#include <Arduino.h>
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+// What a full queue does with a new item
+enum QueueOverflow
+{
+    DROP_OLDEST, // drop the oldest waiting item of the lowest priority, the front stays
+    DROP_NEW     // reject the new item
+};
+
+// Priority queue with a fixed capacity of up to 255 items. The front is the item with the
+// highest priority, items of equal priority keep their arrival order. Queuing an item whose
+// id is already queued replaces that item in place and keeps its position.
+// Items are moved into preallocated slots. A binary heap of slot numbers keeps the order and
+// a second one the order in which items are dropped, both track the heap position of every
+// slot, so push, pop, replacing and dropping are O(log n). Queued ids are found through an
+// open addressing table of id hashes with twice the capacity, which is O(1) on average.
+// T needs a String id, an int8_t priority and a uint32_t seq, which is assigned here.
+template <typename T>
+class NotificationQueue
+{
+private:
+    enum : uint8_t
+    {
+        NO_SLOT = 255
+    };
+
+    typedef bool (NotificationQueue::*Order)(uint8_t, uint8_t) const;
+
+    struct Heap
+    {
+        std::vector<uint8_t> items;     // slot numbers, items[0] comes first
+        std::vector<uint8_t> positions; // position of every used slot in items
+        Order order;
+    };
+
+    std::vector<T> slots;
+    std::vector<uint32_t> idHashes; // id hash of every used slot
+    std::vector<uint8_t> freeSlots;
+    std::vector<uint8_t> ids;       // slot numbers by id hash, NO_SLOT if empty
+    Heap queue;                     // items[0] is the front
+    Heap drops;                     // items[0] is dropped first on overflow
+    uint32_t nextSeq = 1;
+    QueueOverflow overflow = DROP_OLDEST;
+
+    // FNV-1a
+    static uint32_t hashId(const String &id)
+    {
+        uint32_t hash = 2166136261;
+        for (size_t i = 0; i < id.length(); i++)
+        {
+            hash ^= (uint8_t)id[i];
+            hash *= 16777619;
+        }
+        return hash;
+    }
+
+    bool before(uint8_t a, uint8_t b) const
+    {
+        if (slots[a].priority != slots[b].priority)
+            return slots[a].priority > slots[b].priority;
+        return slots[a].seq < slots[b].seq;
+    }
+
+    // Oldest item of the lowest priority first
+    bool dropsBefore(uint8_t a, uint8_t b) const
+    {
+        if (slots[a].priority != slots[b].priority)
+            return slots[a].priority < slots[b].priority;
+        return slots[a].seq < slots[b].seq;
+    }
+
+    void swapHeap(Heap &heap, size_t i, size_t j)
+    {
+        std::swap(heap.items[i], heap.items[j]);
+        heap.positions[heap.items[i]] = i;
+        heap.positions[heap.items[j]] = j;
+    }
+
+    void siftUp(Heap &heap, size_t i)
+    {
+        while (i > 0 && (this->*heap.order)(heap.items[i], heap.items[(i - 1) / 2]))
+        {
+            swapHeap(heap, i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void siftDown(Heap &heap, size_t i)
+    {
+        while (true)
+        {
+            size_t first = i;
+            size_t left = 2 * i + 1;
+            size_t right = left + 1;
+            if (left < heap.items.size() && (this->*heap.order)(heap.items[left], heap.items[first]))
+                first = left;
+            if (right < heap.items.size() && (this->*heap.order)(heap.items[right], heap.items[first]))
+                first = right;
+            if (first == i)
+                return;
+            swapHeap(heap, i, first);
+            i = first;
+        }
+    }
+
+    void heapPush(Heap &heap, uint8_t slot)
+    {
+        heap.positions[slot] = heap.items.size();
+        heap.items.push_back(slot);
+        siftUp(heap, heap.items.size() - 1);
+    }
+
+    void heapRemove(Heap &heap, uint8_t slot)
+    {
+        size_t i = heap.positions[slot];
+        swapHeap(heap, i, heap.items.size() - 1);
+        heap.items.pop_back();
+        if (i < heap.items.size())
+            heapUpdate(heap, heap.items[i]);
+    }
+
+    // Restores the order after the item in the slot changed
+    void heapUpdate(Heap &heap, uint8_t slot)
+    {
+        siftUp(heap, heap.positions[slot]);
+        siftDown(heap, heap.positions[slot]);
+    }
+
+    size_t idMask() const
+    {
+        return ids.size() - 1;
+    }
+
+    // Position of the id in ids, or ids.size() if it isn't queued
+    size_t findId(const String &id) const
+    {
+        uint32_t hash = hashId(id);
+        for (size_t i = hash & idMask(); ids[i] != NO_SLOT; i = (i + 1) & idMask())
+        {
+            uint8_t slot = ids[i];
+            if (idHashes[slot] == hash && slots[slot].id == id)
+                return i;
+        }
+        return ids.size();
+    }
+
+    void indexId(uint8_t slot)
+    {
+        if (slots[slot].id.isEmpty())
+            return;
+        idHashes[slot] = hashId(slots[slot].id);
+        size_t i = idHashes[slot] & idMask();
+        while (ids[i] != NO_SLOT)
+            i = (i + 1) & idMask();
+        ids[i] = slot;
+    }
+
+    // Removes the entry and moves the following ones of the probe sequence back,
+    // so lookups never have to skip deleted entries
+    void unindexId(uint8_t slot)
+    {
+        if (slots[slot].id.isEmpty())
+            return;
+        size_t i = findId(slots[slot].id);
+        if (i == ids.size())
+            return;
+        for (size_t j = (i + 1) & idMask(); ids[j] != NO_SLOT; j = (j + 1) & idMask())
+        {
+            size_t home = idHashes[ids[j]] & idMask();
+            if (((j - home) & idMask()) >= ((j - i) & idMask()))
+            {
+                ids[i] = ids[j];
+                i = j;
+            }
+        }
+        ids[i] = NO_SLOT;
+    }
+
+    void remove(uint8_t slot)
+    {
+        heapRemove(queue, slot);
+        heapRemove(drops, slot);
+        unindexId(slot);
+        slots[slot] = T();
+        freeSlots.push_back(slot);
+    }
+
+    // Oldest waiting item of the lowest priority, the front if nothing else is queued
+    uint8_t victim() const
+    {
+        uint8_t slot = drops.items[0];
+        if (slot != queue.items[0] || drops.items.size() == 1)
+            return slot;
+        // The front is the root of the drop heap, the next item to drop is one of its children
+        if (drops.items.size() > 2 && dropsBefore(drops.items[2], drops.items[1]))
+            return drops.items[2];
+        return drops.items[1];
+    }
+
+    void reset(size_t capacity)
+    {
+        slots.clear();
+        slots.resize(capacity);
+        idHashes.assign(capacity, 0);
+        size_t tableSize = 1;
+        while (tableSize < 2 * capacity)
+            tableSize <<= 1;
+        ids.assign(tableSize, NO_SLOT);
+        for (Heap *heap : {&queue, &drops})
+        {
+            heap->items.clear();
+            heap->items.reserve(capacity);
+            heap->positions.assign(capacity, 0);
+        }
+        queue.order = &NotificationQueue::before;
+        drops.order = &NotificationQueue::dropsBefore;
+        freeSlots.clear();
+        for (size_t slot = capacity; slot > 0; slot--)
+            freeSlots.push_back(slot - 1);
+    }
+
+public:
+    uint32_t pushed = 0;
+    uint32_t dropped = 0;
+    uint32_t replaced = 0;
+    size_t highWater = 0;
+
+    explicit NotificationQueue(size_t capacity)
+    {
+        reset(std::min<size_t>(std::max<size_t>(capacity, 1), 255));
+    }
+
+    // Keeps the items at the front that still fit
+    void setCapacity(size_t capacity)
+    {
+        capacity = std::min<size_t>(std::max<size_t>(capacity, 1), 255);
+        if (capacity == slots.size())
+            return;
+        std::vector<T> queued;
+        while (!empty())
+        {
+            queued.push_back(std::move(front()));
+            pop();
+        }
+        reset(capacity);
+        for (T &item : queued)
+        {
+            if (size() < capacity)
+                push(std::move(item));
+            else
+                dropped++;
+        }
+    }
+
+    void setOverflow(QueueOverflow policy)
+    {
+        overflow = policy;
+    }
+
+    // Returns false if the item was dropped
+    bool push(T &&item)
+    {
+        pushed++;
+        if (!item.id.isEmpty())
+        {
+            size_t i = findId(item.id);
+            if (i != ids.size())
+            {
+                uint8_t slot = ids[i];
+                item.seq = slots[slot].seq;
+                slots[slot] = std::move(item);
+                heapUpdate(queue, slot);
+                heapUpdate(drops, slot);
+                replaced++;
+                return true;
+            }
+        }
+        if (freeSlots.empty())
+        {
+            dropped++;
+            if (overflow == DROP_NEW)
+                return false;
+            remove(victim());
+        }
+        uint8_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        item.seq = nextSeq++;
+        slots[slot] = std::move(item);
+        heapPush(queue, slot);
+        heapPush(drops, slot);
+        indexId(slot);
+        highWater = std::max(highWater, size());
+        return true;
+    }
+
+    // Replaces the front item, or queues the item if the queue is empty or its id is queued
+    void replaceFront(T &&item)
+    {
+        if (empty() || (!item.id.isEmpty() && findId(item.id) != ids.size()))
+        {
+            push(std::move(item));
+            return;
+        }
+        pushed++;
+        replaced++;
+        uint8_t slot = queue.items[0];
+        unindexId(slot);
+        item.seq = slots[slot].seq;
+        slots[slot] = std::move(item);
+        indexId(slot);
+        heapUpdate(queue, slot);
+        heapUpdate(drops, slot);
+    }
+
+    void pop()
+    {
+        if (!empty())
+            remove(queue.items[0]);
+    }
+
+    void clear()
+    {
+        while (!empty())
+            pop();
+    }
+
+    T &front()
+    {
+        return slots[queue.items[0]];
+    }
+
+    bool empty() const
+    {
+        return queue.items.empty();
+    }
+
+    size_t size() const
+    {
+        return queue.items.size();
+    }
+
+    size_t capacity() const
+    {
+        return slots.size();
+    }
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include <LittleFS.h>
 #include <LightDependentResistor.h>
 #include <MenuManager.h>
+#include "JsonArena.h"
 
 #ifdef ULANZI
 // Pinouts für das ULANZI-Environment
@@ -236,8 +237,9 @@ void PeripheryManager_::setVolume(uint8_t vol)
 
 bool PeripheryManager_::parseSound(const char *json)
 {
-    StaticJsonDocument<128> doc;
-    DeserializationError error = deserializeJson(doc, json);
+    JsonLease lease(ARENA_PAYLOAD);
+    DynamicJsonDocument &doc = lease.doc();
+    DeserializationError error = lease.parse(json);
     if (error)
     {
         return playFromFile(String(json));
@@ -0,0 +1,86 @@
+#include "Profiler.h"
+
+#ifdef PERF_PROFILING
+
+#include <ArduinoJson.h>
+#include <algorithm>
+
+// The getter for the instantiated singleton instance
+Profiler_ &Profiler_::getInstance()
+{
+    static Profiler_ instance;
+    return instance;
+}
+
+// Initialize the global shared instance
+Profiler_ &Profiler = Profiler.getInstance();
+
+Profiler_::Profiler_()
+{
+    stages.reserve(PROFILER_STAGES);
+}
+
+// Index of the stage with the given name, registered on first use
+uint8_t Profiler_::stage(const char *name)
+{
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint8_t index = PROFILER_NO_STAGE;
+    for (size_t i = 0; i < stages.size() && index == PROFILER_NO_STAGE; i++)
+    {
+        if (stages[i].name == name)
+            index = i;
+    }
+    if (index == PROFILER_NO_STAGE && stages.size() < PROFILER_STAGES)
+    {
+        index = stages.size();
+        stages.emplace_back();
+        stages.back().name = name;
+    }
+    xSemaphoreGive(lock);
+    return index;
+}
+
+void Profiler_::record(uint8_t stage, uint32_t micros)
+{
+    if (stage == PROFILER_NO_STAGE)
+        return;
+    Stage &s = stages[stage];
+    s.samples[s.next] = micros > UINT16_MAX ? UINT16_MAX : micros;
+    s.next = (s.next + 1) % PROFILER_WINDOW;
+    if (s.count < PROFILER_WINDOW)
+        s.count++;
+}
+
+// min, avg and p99 in µs of the last PROFILER_WINDOW samples of every stage
+String Profiler_::getStats()
+{
+    DynamicJsonDocument doc(4096);
+    uint16_t sorted[PROFILER_WINDOW];
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (Stage &s : stages)
+    {
+        uint8_t count = s.count;
+        memcpy(sorted, s.samples, count * sizeof(uint16_t));
+
+        if (count == 0)
+            continue;
+        std::sort(sorted, sorted + count);
+        uint32_t sum = 0;
+        for (uint8_t i = 0; i < count; i++)
+            sum += sorted[i];
+
+        JsonObject stage = doc.createNestedObject(s.name);
+        stage[F("min")] = sorted[0];
+        stage[F("avg")] = sum / count;
+        stage[F("p99")] = sorted[(count * 99 + 99) / 100 - 1];
+        stage[F("samples")] = count;
+    }
+    xSemaphoreGive(lock);
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef Profiler_h
+#define Profiler_h
+
+// Per stage render timings. Enabled with the build flag -DPERF_PROFILING,
+// without it PROFILE_STAGE expands to nothing and no code is generated.
+#ifdef PERF_PROFILING
+
+#include <Arduino.h>
+#include <vector>
+
+#define PROFILER_WINDOW 128
+#define PROFILER_STAGES 64     // native, custom and overlay apps plus the fixed stages
+#define PROFILER_NO_STAGE 0xFF // returned by stage() once all are taken, never recorded
+
+class Profiler_
+{
+private:
+    Profiler_();
+
+    // Ring buffer of the last samples in µs
+    struct Stage
+    {
+        String name;
+        uint16_t samples[PROFILER_WINDOW];
+        uint8_t count = 0;
+        uint8_t next = 0;
+    };
+
+    // Reserved up front, so registering a stage never moves one that is being recorded.
+    // Each stage is only recorded from one task, the UI or the LED output task.
+    std::vector<Stage> stages;
+    SemaphoreHandle_t lock = xSemaphoreCreateMutex(); // guards registering against reading the stats
+
+public:
+    static Profiler_ &getInstance();
+    uint8_t stage(const char *name);
+    void record(uint8_t stage, uint32_t micros);
+    String getStats();
+};
+
+extern Profiler_ &Profiler;
+
+// Measures the enclosing scope
+class ProfileScope
+{
+private:
+    uint8_t stage;
+    uint32_t start;
+
+public:
+    ProfileScope(uint8_t stage) : stage(stage), start(micros()) {}
+    ~ProfileScope() { Profiler.record(stage, micros() - start); }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// The stage is registered the first time the line runs, later passes only record
+#define PROFILE_STAGE(name)                                                             \
+    static const uint8_t PROFILE_CONCAT(profileStage, __LINE__) = Profiler.stage(name); \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileStage, __LINE__))
+// For stages registered with Profiler.stage() beforehand, e.g. one per app
+#define PROFILE_STAGE_INDEX(stage) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(stage)
+
+#else
+
+#define PROFILE_STAGE(name)
+#define PROFILE_STAGE_INDEX(stage)
+
+#endif
+
+#endif
@@ -11,6 +11,9 @@
 #include "DisplayManager.h"
 #include "UpdateManager.h"
 #include "PeripheryManager.h"
+#include "IconCache.h"
+#include "GifPlayer.h"
+#include "Profiler.h"
 
 WebServer server(80);
 FSWebServer mws(LittleFS, server);
@@ -137,8 +140,23 @@ void addHandler()
                     }else{
                         mws.webserver->send(500,F("text/plain"),F("ErrorParsingJson")); 
                     } });
+    mws.addHandler("/api/custom", HTTP_PATCH, []()
+                   { 
+                    if (DisplayManager.patchCustomPage(mws.webserver->arg("name"),mws.webserver->arg("plain").c_str())){
+                        mws.webserver->send(200,F("text/plain"),F("OK")); 
+                    }else{
+                        mws.webserver->send(500,F("text/plain"),F("FAILED")); 
+                    } });
     mws.addHandler("/api/stats", HTTP_GET, []()
                    { mws.webserver->send_P(200, "application/json", DisplayManager.getStats().c_str()); });
+#ifdef PERF_PROFILING
+    mws.addHandler("/api/perf", HTTP_GET, []()
+                   { mws.webserver->send_P(200, "application/json", Profiler.getStats().c_str()); });
+    mws.addHandler("/api/benchmark", HTTP_GET, []()
+                   {
+                       uint16_t frames = mws.webserver->hasArg("frames") ? constrain(mws.webserver->arg("frames").toInt(), 1, 500) : 100;
+                       mws.webserver->send_P(200, "application/json", DisplayManager.runBenchmark(frames).c_str()); });
+#endif
     mws.addHandler("/api/screen", HTTP_GET, []()
                    { mws.webserver->send_P(200, "application/json", DisplayManager.ledsAsJson().c_str()); });
     mws.addHandler("/api/indicator1", HTTP_POST, []()
@@ -209,6 +227,16 @@ void ServerManager_::setup()
         mws.addCSS(custom_css);
         mws.addJavascript(custom_script);
         mws.addHandler("/save", HTTP_POST, saveHandler);
+        mws.onFileChanged([](const String &path)
+                          {
+                              // Drop decoded icons when the file is replaced or removed
+                              if (path.startsWith("/ICONS/"))
+                              {
+                                  String name = path.substring(path.lastIndexOf('/') + 1);
+                                  IconCache.invalidate(name);
+                                  GifCache::getInstance().invalidate(name);
+                                  DisplayManager.invalidateStaticFrames();
+                              } });
         addHandler();
 
         DEBUG_PRINTLN(F("Webserver loaded"));
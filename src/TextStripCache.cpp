@@ -0,0 +1,80 @@
+#include "TextStripCache.h"
+
+// The getter for the instantiated singleton instance
+TextStripCache_ &TextStripCache_::getInstance()
+{
+    static TextStripCache_ instance;
+    return instance;
+}
+
+// Initialize the global shared instance
+TextStripCache_ &TextStrips = TextStrips.getInstance();
+
+static size_t stripBytes(const TextStrip &strip)
+{
+    return TextStrip::bytesFor(strip.width, !strip.hues.empty()) + strip.text.length();
+}
+
+void TextStripCache_::setBudget(size_t bytes)
+{
+    budget = bytes;
+    evict(0);
+}
+
+bool TextStripCache_::fits(size_t bytes)
+{
+    return bytes > 0 && bytes <= budget;
+}
+
+void TextStripCache_::evict(size_t required)
+{
+    while (!strips.empty() && usedBytes + required > budget)
+    {
+        usedBytes -= stripBytes(strips.back());
+        strips.pop_back();
+        ++evictions;
+    }
+}
+
+TextStrip *TextStripCache_::find(uint32_t key, const String &text, uint16_t width)
+{
+    for (auto it = strips.begin(); it != strips.end(); ++it)
+    {
+        if (it->key == key && it->width == width && it->text == text)
+        {
+            // Move to the front so it is evicted last
+            strips.splice(strips.begin(), strips, it);
+            ++hits;
+            return &strips.front();
+        }
+    }
+    ++misses;
+    return nullptr;
+}
+
+TextStrip *TextStripCache_::insert(TextStrip &&strip)
+{
+    size_t size = stripBytes(strip);
+    if (!fits(size))
+        return nullptr;
+    evict(size);
+    strips.push_front(std::move(strip));
+    usedBytes += size;
+    return &strips.front();
+}
+
+void TextStripCache_::clear()
+{
+    strips.clear();
+    usedBytes = 0;
+}
+
+size_t TextStripCache_::getUsedBytes()
+{
+    return usedBytes;
+}
+
+size_t TextStripCache_::getCount()
+{
+    return strips.size();
+}
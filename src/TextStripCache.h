@@ -0,0 +1,64 @@
+#ifndef TextStripCache_h
+#define TextStripCache_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <list>
+#include <vector>
+
+// Part of a text that is drawn in one color, or as rainbow
+struct TextSegment
+{
+    const char *text;
+    uint16_t width;
+    CRGB color;
+    bool rainbow;
+};
+
+// A text rasterized once into an offscreen strip which is blitted at the current scroll position.
+struct TextStrip
+{
+    uint32_t key;
+    String text; // the source text, so a key collision can't show another text
+    uint16_t width;
+    std::vector<uint8_t> columns; // one bit per row
+    std::vector<CRGB> colors;     // one color per column
+    std::vector<int16_t> hues;    // rainbow base hue per column, -1 for solid columns. Empty without rainbow segments
+
+    static size_t bytesFor(uint16_t width, bool rainbow)
+    {
+        return width * (sizeof(uint8_t) + sizeof(CRGB) + (rainbow ? sizeof(int16_t) : 0));
+    }
+};
+
+// Keeps rendered strips of scrolling texts, keyed by a hash over everything that affects their look.
+// A strip is only found if its text and width match as well.
+// Strips are evicted in LRU order once the byte budget is exceeded.
+class TextStripCache_
+{
+private:
+    TextStripCache_() = default;
+
+    std::list<TextStrip> strips; // most recently used first
+    size_t usedBytes = 0;
+    size_t budget = 8192;
+
+    void evict(size_t required);
+
+public:
+    static TextStripCache_ &getInstance();
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+    void setBudget(size_t bytes);
+    bool fits(size_t bytes);
+    TextStrip *find(uint32_t key, const String &text, uint16_t width);
+    TextStrip *insert(TextStrip &&strip);
+    void clear();
+    size_t getUsedBytes();
+    size_t getCount();
+};
+
+extern TextStripCache_ &TextStrips;
+
+#endif
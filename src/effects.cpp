@@ -4,6 +4,7 @@ const CRGBPalette16 palette = RainbowColors_p;
 
 void Pacifica(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     uint8_t speed = 2;
@@ -21,13 +22,14 @@ void Pacifica(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             v += sin16(ulx * 7 + uly * 2 - sPacificaTime) / 16;
             v = v / 3;
             CRGB color = ColorFromPalette(OceanColors_p, v);
-            matrix->drawPixel(x + i, y + j, color);
+            canvas.setPixel(x + i, y + j, color);
         }
     }
 }
 
 void TheaterChase(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static uint16_t j = 0;
@@ -47,11 +49,11 @@ void TheaterChase(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             {
                 uint8_t colorIndex = (i * 256 / cols) & 255;
                 CRGB color = ColorFromPalette(RainbowColors_p, colorIndex);
-                matrix->drawPixel(x + i, y + k, color);
+                canvas.setPixel(x + i, y + k, color);
             }
             else
             {
-                matrix->drawPixel(x + i, y + k, matrix->Color(0, 0, 0));
+                canvas.setPixel(x + i, y + k, matrix->Color(0, 0, 0));
             }
         }
     }
@@ -59,6 +61,7 @@ void TheaterChase(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 
 void Plasma(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static uint32_t time = 0;
@@ -69,7 +72,7 @@ void Plasma(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
         {
             uint8_t value = sin8(i * 10 + time) + sin8(j * 10 + time / 2) + sin8((i + j) * 10 + time / 3) / 3;
             CRGB color = ColorFromPalette(RainbowColors_p, value);
-            matrix->drawPixel(x + i, y + j, color);
+            canvas.setPixel(x + i, y + j, color);
         }
     }
     time += 1;
@@ -83,6 +86,7 @@ struct MatrixColumn
 
 void Matrix(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static uint32_t lastMove = 0;
@@ -137,13 +141,14 @@ void Matrix(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
     {
         for (uint16_t j = 0; j < rows; j++)
         {
-            matrix->drawPixel(x + i, y + j, ledState[i][j]);
+            canvas.setPixel(x + i, y + j, ledState[i][j]);
         }
     }
 }
 
 void SwirlIn(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static uint32_t lastUpdate = 0;
@@ -169,13 +174,14 @@ void SwirlIn(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             uint16_t dist = sqrt(xDiff * xDiff + yDiff * yDiff);
             uint8_t hue = map(dist, 0, sqrt(centerX * centerX + centerY * centerY), 0, 255) + angle;
             CRGB color = ColorFromPalette(palette, hue);
-            matrix->drawPixel(x + i, y + j, color);
+            canvas.setPixel(x + i, y + j, color);
         }
     }
 }
 
 void SwirlOut(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static uint32_t lastUpdate = 0;
@@ -201,13 +207,14 @@ void SwirlOut(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             uint16_t dist = sqrt(xDiff * xDiff + yDiff * yDiff);
             uint8_t hue = 255 - map(dist, 0, sqrt(centerX * centerX + centerY * centerY), 0, 255) + angle;
             CRGB color = ColorFromPalette(palette, hue);
-            matrix->drawPixel(x + i, y + j, color);
+            canvas.setPixel(x + i, y + j, color);
         }
     }
 }
 
 void ColorWaves(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static uint32_t lastUpdate = 0;
@@ -227,7 +234,7 @@ void ColorWaves(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             uint8_t sat = 255;
             uint8_t val = max((sin16(lastUpdate + i * 4096) + 32768) >> 8, 100); // 85 is around 1/3 of 255
             CHSV color = CHSV(hue, sat, val);
-            matrix->drawPixel(x + i, y + j, color);
+            canvas.setPixel(x + i, y + j, color);
         }
     }
 }
@@ -245,6 +252,7 @@ Star stars[32][8]; // Create a buffer to store the state of the LEDs
 
 void TwinklingStars(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static uint32_t lastUpdate = 0;
@@ -258,7 +266,7 @@ void TwinklingStars(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             stars[i][j].brightness -= 0.01;
             if (stars[i][j].brightness < 0)
                 stars[i][j].brightness = 0;
-            matrix->drawPixel(x + i, y + j, stars[i][j].color.nscale8_video(stars[i][j].brightness * 255));
+            canvas.setPixel(x + i, y + j, stars[i][j].color.nscale8_video(stars[i][j].brightness * 255));
         }
     }
 
@@ -274,7 +282,7 @@ void TwinklingStars(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             // Star color - varying the saturation and value for shades of blue and white
             stars[starX][starY].color = CHSV(160, random8(100, 255), MAX_BRIGHTNESS);
             stars[starX][starY].brightness = 1.0;
-            matrix->drawPixel(x + starX, y + starY, stars[starX][starY].color);
+            canvas.setPixel(x + starX, y + starY, stars[starX][starY].color);
         }
     }
 }
@@ -303,15 +311,16 @@ uint16_t eye[5][64] = {
 
 void LookingEyes(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     if (blinkCountdown < sizeof(blinkIndex) / sizeof(blinkIndex[0]) - 1)
     {
-        matrix->drawRGBBitmap(6 + x, 0 + y, eye[blinkIndex[blinkCountdown]], 8, 8);
-        matrix->drawRGBBitmap(18 + x, 0 + y, eye[blinkIndex[blinkCountdown]], 8, 8);
+        canvas.blit(6 + x, 0 + y, eye[blinkIndex[blinkCountdown]], 8, 8);
+        canvas.blit(18 + x, 0 + y, eye[blinkIndex[blinkCountdown]], 8, 8);
     }
     else
     {
-        matrix->drawRGBBitmap(6 + x, 0 + y, eye[0], 8, 8);
-        matrix->drawRGBBitmap(18 + x, 0 + y, eye[0], 8, 8);
+        canvas.blit(6 + x, 0 + y, eye[0], 8, 8);
+        canvas.blit(18 + x, 0 + y, eye[0], 8, 8);
     }
 
     blinkCountdown = blinkCountdown - 0.1;
@@ -323,8 +332,8 @@ void LookingEyes(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
     if (gazeCountdown <= gazeFrames)
     {
         gazeCountdown -= 0.5;
-        matrix->fillRect(newX - (dX * gazeCountdown / gazeFrames) + 6 + x, newY - (dY * gazeCountdown / gazeFrames) + y, 2, 2, 0);
-        matrix->fillRect(newX - (dX * gazeCountdown / gazeFrames) + 18 + x, newY - (dY * gazeCountdown / gazeFrames) + y, 2, 2, 0);
+        canvas.fillRect(newX - (dX * gazeCountdown / gazeFrames) + 6 + x, newY - (dY * gazeCountdown / gazeFrames) + y, 2, 2, 0);
+        canvas.fillRect(newX - (dX * gazeCountdown / gazeFrames) + 18 + x, newY - (dY * gazeCountdown / gazeFrames) + y, 2, 2, 0);
         if (gazeCountdown == 0)
         {
             eyeX = newX;
@@ -368,8 +377,8 @@ void LookingEyes(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
     else
     {
         gazeCountdown -= 0.5;
-        matrix->fillRect(eyeX + 6 + x, eyeY + y, 2, 2, 0);
-        matrix->fillRect(eyeX + 18 + x, eyeY + y, 2, 2, 0);
+        canvas.fillRect(eyeX + 6 + x, eyeY + y, 2, 2, 0);
+        canvas.fillRect(eyeX + 18 + x, eyeY + y, 2, 2, 0);
     }
 }
 
@@ -492,6 +501,7 @@ void updateDirection()
 
 void SnakeGame(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     if (isGameOver)
@@ -593,10 +603,10 @@ void SnakeGame(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
     // Draw the snake
     for (uint8_t i = 0; i < snakeLength; i++)
     {
-        matrix->drawPixel(x + snake[i].x, y + snake[i].y, colors[snake[i].colorIndex]);
+        canvas.setPixel(x + snake[i].x, y + snake[i].y, colors[snake[i].colorIndex]);
     }
     // Draw the apple
-    matrix->drawPixel(x + apple.x, y + apple.y, matrix->Color(255, 0, 0));
+    canvas.setPixel(x + apple.x, y + apple.y, matrix->Color(255, 0, 0));
 }
 
 // ######## Fireworks ############
@@ -617,6 +627,7 @@ uint32_t fireworkInterval = 350; // milliseconds between new fireworks
 
 void Fireworks(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
 
@@ -655,18 +666,18 @@ void Fireworks(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
                 fireworks[i].exploded = true;
                 fireworks[i].color = CHSV(random(255), 255, fireworks[i].life * 4); // The exploded firework has a random color
             }
-            matrix->drawPixel(x + fireworks[i].x, y + fireworks[i].y, fireworks[i].color);
+            canvas.setPixel(x + fireworks[i].x, y + fireworks[i].y, fireworks[i].color);
             // Draw a few pixels around the firework to simulate explosion
             if (fireworks[i].exploded)
             {
                 if (fireworks[i].x > 0)
-                    matrix->drawPixel(x + fireworks[i].x - 1, y + fireworks[i].y, fireworks[i].color);
+                    canvas.setPixel(x + fireworks[i].x - 1, y + fireworks[i].y, fireworks[i].color);
                 if (fireworks[i].x < cols - 1)
-                    matrix->drawPixel(x + fireworks[i].x + 1, y + fireworks[i].y, fireworks[i].color);
+                    canvas.setPixel(x + fireworks[i].x + 1, y + fireworks[i].y, fireworks[i].color);
                 if (fireworks[i].y > 0)
-                    matrix->drawPixel(x + fireworks[i].x, y + fireworks[i].y - 1, fireworks[i].color);
+                    canvas.setPixel(x + fireworks[i].x, y + fireworks[i].y - 1, fireworks[i].color);
                 if (fireworks[i].y < rows - 1)
-                    matrix->drawPixel(x + fireworks[i].x, y + fireworks[i].y + 1, fireworks[i].color);
+                    canvas.setPixel(x + fireworks[i].x, y + fireworks[i].y + 1, fireworks[i].color);
             }
         }
     }
@@ -689,6 +700,7 @@ CRGB RippleLeds[32][8]; // temporary LEDs state
 
 void RippleEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
 
@@ -727,7 +739,7 @@ void RippleEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             }
 
             // Apply the temporary LEDs to the actual matrix
-            matrix->drawPixel(x + i, y + j, RippleLeds[i][j]);
+            canvas.setPixel(x + i, y + j, RippleLeds[i][j]);
         }
     }
 
@@ -739,6 +751,7 @@ void RippleEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 
 void PlasmaCloudEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     static float plasmaTime = 0;
@@ -751,7 +764,7 @@ void PlasmaCloudEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
             float noise = inoise8(i * 16, j * 16, plasmaTime);
             uint8_t hue = noise * 255 / 1024 + hueShift; // Map noise value to hue (0-255) and add hueShift
             CRGB color = CHSV(hue, 255, 255);
-            matrix->drawPixel(x + i, y + j, color);
+            canvas.setPixel(x + i, y + j, color);
         }
     }
 
@@ -764,6 +777,7 @@ void PlasmaCloudEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 
 void CheckerboardEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
 
@@ -779,11 +793,11 @@ void CheckerboardEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
         {
             if ((i % 2 == 0 && j % 2 == 0) || (i % 2 != 0 && j % 2 != 0))
             {
-                matrix->drawPixel(x + i, y + j, color1);
+                canvas.setPixel(x + i, y + j, color1);
             }
             else
             {
-                matrix->drawPixel(x + i, y + j, color2);
+                canvas.setPixel(x + i, y + j, color2);
             }
         }
     }
@@ -808,9 +822,10 @@ Drop drops[MAX_DROPS];
 
 void RaindropsEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
-    matrix->fillScreen(0); // Clear the matrix each frame
+    canvas.clear(); // Clear the matrix each frame
 
     // Initialize drops with random positions and colors
     for (uint8_t i = 0; i < MAX_DROPS; i++)
@@ -829,7 +844,7 @@ void RaindropsEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
         drops[i].pos += DROP_SPEED;
         if (drops[i].pos <= rows)
         {
-            matrix->drawPixel(x + i, y + (int)drops[i].pos, drops[i].color);
+            canvas.setPixel(x + i, y + (int)drops[i].pos, drops[i].color);
         }
     }
 }
@@ -839,6 +854,7 @@ CRGB leds1[32][8];
 
 void RadarEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
     const float centerX = (cols - 1) / 2.0;
@@ -869,7 +885,7 @@ void RadarEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
     {
         for (uint16_t j = 0; j < rows; j++)
         {
-            matrix->drawPixel(x + i, y + j, leds1[i][j]);
+            canvas.setPixel(x + i, y + j, leds1[i][j]);
         }
     }
 
@@ -895,6 +911,7 @@ struct Ball
 
 void PingPongEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
 
@@ -954,12 +971,12 @@ void PingPongEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
     // Draw the paddles and the ball
     for (int i = 0; i < PADDLE_HEIGHT; i++)
     {
-        matrix->drawPixel(x, y + paddle1.y + i, matrix->Color(255, 255, 255));
-        matrix->drawPixel(x + cols - 1, y + paddle2.y + i, matrix->Color(255, 255, 255));
+        canvas.setPixel(x, y + paddle1.y + i, matrix->Color(255, 255, 255));
+        canvas.setPixel(x + cols - 1, y + paddle2.y + i, matrix->Color(255, 255, 255));
     }
     for (int i = 0; i < BALL_SIZE; i++)
     {
-        matrix->drawPixel(x + ball.x, y + ball.y + i, matrix->Color(255, 0, 0));
+        canvas.setPixel(x + ball.x, y + ball.y + i, matrix->Color(255, 0, 0));
     }
 }
 
@@ -1011,6 +1028,7 @@ bool bricksRemain()
 
 void BrickBreakerEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
 {
+    Canvas &canvas = Canvas::getInstance();
     const uint16_t cols = matrix->width();
     const uint16_t rows = matrix->height();
 
@@ -1080,11 +1098,11 @@ void BrickBreakerEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
     // Draw the paddle, the ball, and the bricks
     for (int i = 0; i < PADDLE_WIDTH; i++)
     {
-        matrix->drawPixel(x + paddle.x + i, y + rows - 1, matrix->Color(255, 255, 255));
+        canvas.setPixel(x + paddle.x + i, y + rows - 1, matrix->Color(255, 255, 255));
     }
     for (int i = 0; i < BALL_SIZE; i++)
     {
-        matrix->drawPixel(x + ball.x, y + ball.y + i, matrix->Color(255, 0, 0));
+        canvas.setPixel(x + ball.x, y + ball.y + i, matrix->Color(255, 0, 0));
     }
     for (int i = 0; i < BRICK_ROWS; i++)
     {
@@ -1092,7 +1110,7 @@ void BrickBreakerEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y)
         {
             if (bricks[i][j])
             {
-                matrix->drawPixel(x + j * (cols / BRICK_COLS), y + i, matrix->Color(0, 0, 255));
+                canvas.setPixel(x + j * (cols / BRICK_COLS), y + i, matrix->Color(0, 0, 255));
             }
         }
     }
@@ -1118,6 +1136,8 @@ Effect effects[] = {
     {"TwinklingStars", TwinklingStars},
     {"ColorWaves", ColorWaves}};
 
+const uint8_t effectsCount = sizeof(effects) / sizeof(effects[0]);
+
 void callEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y, int index)
 {
     if (index >= 0)
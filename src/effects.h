@@ -3,6 +3,7 @@
 
 #include <FastLED.h>
 #include <FastLED_NeoMatrix.h>
+#include "Canvas.h"
 #include <ArduinoJson.h>
 #include "DisplayManager.h"
 
@@ -14,6 +15,7 @@ struct Effect
     EffectFunc func;
 };
 extern Effect effects[];
+extern const uint8_t effectsCount;
 void callEffect(FastLED_NeoMatrix *matrix, int16_t x, int16_t y, int index);
 int getEffectIndex(String name);
 #endif
\ No newline at end of file
@@ -38,24 +38,6 @@
 #include "Globals.h"
 #include "UpdateManager.h"
 
-TaskHandle_t taskHandle;
-volatile bool StopTask = false;
-
-void BootAnimation(void *parameter)
-{
-  const TickType_t xDelay = 1 / portTICK_PERIOD_MS;
-  while (true)
-  {
-    if (StopTask)
-    {
-      break;
-    }
-    DisplayManager.HSVtext(4, 6, "AWTRIX", true, 0);
-    vTaskDelay(xDelay);
-  }
-  vTaskDelete(NULL);
-}
-
 void setup()
 {
   pinMode(15, OUTPUT);
@@ -68,7 +50,7 @@ void setup()
   DisplayManager.setup();
   DisplayManager.HSVtext(9, 6, VERSION, true, 0);
   delay(500);
-  xTaskCreatePinnedToCore(BootAnimation, "Task", 10000, NULL, 1, &taskHandle, 0);
+  DisplayManager.startBootAnimation();
   ServerManager.setup();
   // PeripheryManager.playBootSound();
   if (ServerManager.isConnected)
@@ -78,7 +60,7 @@ void setup()
     DisplayManager.loadCustomApps();
     UpdateManager.setup();
     DisplayManager.startArtnet();
-    StopTask = true;
+    DisplayManager.stopBootAnimation();
     float x = 4;
     while (x >= -85)
     {
@@ -89,7 +71,7 @@ void setup()
   else
   {
     AP_MODE = true;
-    StopTask = true;
+    DisplayManager.stopBootAnimation();
   }
   delay(200);
   DisplayManager.setBrightness(BRIGHTNESS);